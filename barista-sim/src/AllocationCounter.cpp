@@ -0,0 +1,41 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> gAllocations{0};
+}  // namespace
+
+#if defined(BARISTA_SIM_COUNT_ALLOCATIONS)
+// The default array and nothrow forms forward to these, so replacing the
+// plain pair is enough to see every ordinary allocation.
+void* operator new(std::size_t size) {
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+#endif
+
+bool allocationCountingEnabled() {
+#if defined(BARISTA_SIM_COUNT_ALLOCATIONS)
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::uint64_t allocationCount() {
+  return gAllocations.load(std::memory_order_relaxed);
+}
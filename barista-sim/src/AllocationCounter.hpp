@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+// Process-wide heap allocation counter. Only live when the build defines
+// BARISTA_SIM_COUNT_ALLOCATIONS (CMake option of the same name), which
+// replaces global operator new; otherwise the count stays at zero.
+[[nodiscard]] bool allocationCountingEnabled();
+[[nodiscard]] std::uint64_t allocationCount();
@@ -3,17 +3,22 @@
 #include <SFML/Config.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <optional>
+#include <random>
+#include <thread>
+#include <utility>
 
 #include "CafeScene.hpp"
+#include "LoadingScene.hpp"
 #include "ReportScene.hpp"
 #include "Resources.hpp"
 
 namespace {
 constexpr unsigned kWindowWidth = 1280;
 constexpr unsigned kWindowHeight = 720;
-constexpr float kFixedTimeStep = 1.0f / 60.0f;
 
 [[nodiscard]] sf::VideoMode makeVideoMode(unsigned width, unsigned height) {
 #if SFML_VERSION_MAJOR >= 3
@@ -24,67 +29,197 @@ constexpr float kFixedTimeStep = 1.0f / 60.0f;
 }
 }  // namespace
 
-App::App()
-    : window_(makeVideoMode(kWindowWidth, kWindowHeight), "Barista Ordering Simulator",
-              sf::Style::Titlebar | sf::Style::Close) {
+App::App(AppOptions options)
+    : options_(std::move(options)),
+      window_(makeVideoMode(kWindowWidth, kWindowHeight), "Barista Ordering Simulator",
+              sf::Style::Titlebar | sf::Style::Close),
+      jobs_(options_.workerThreads),
+      dialogue_(options_.scenarioPath.empty() ? DialogueGraph::builtin()
+                                              : DialogueGraph::loadScenario(options_.scenarioPath)),
+      profiler_(options_.profileFrames),
+      timestep_(1.0f / std::max(1.0f, options_.simulationHz), options_.timeStepPolicy,
+                options_.maxTicksPerFrame) {
   window_.setVerticalSyncEnabled(false);
   window_.setFramerateLimit(60);
 
   audio_.setResources(&resources_);
+  audio_.setVoiceCount(options_.audioVoices);
+  profiler_.setEnabled(options_.profile);
+  recordingStart_ = std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
 
-  try {
-    resources_.loadTexture("cafe_bg", "assets/textures/cafe_bg.png");
-    resources_.loadTexture("player", "assets/textures/player.png");
-    resources_.loadTexture("barista", "assets/textures/barista.png");
-    resources_.loadTexture("customer", "assets/textures/customer.png");
-    resources_.loadTexture("ui_panel", "assets/textures/ui_panel.png");
-
-    resources_.loadFont("ui", "assets/fonts/ui_font.ttf");
-
-    resources_.loadSoundBuffer("ding", "assets/audio/ding.ogg");
-    resources_.loadSoundBuffer("step", "assets/audio/step.ogg");
-    resources_.loadSoundBuffer("ui_click", "assets/audio/ui_click.ogg");
-  } catch (const std::exception& ex) {
-    std::cerr << "Failed to load resources: " << ex.what() << '\n';
-    throw;
-  }
-
-  restartSimulation();
+  loader_ = std::make_unique<AssetLoader>(resources_, true, &audio_);
+  requestScene([this]() {
+    return std::make_unique<LoadingScene>(*this, createContext(), *loader_);
+  });
 }
 
 App::~App() {
+  loader_.reset();
   audio_.stopMusic();
   resources_.clear();
 }
 
 void App::run() {
+  runLoading();
+
+  if (options_.pipelined) {
+    runPipelined();
+    return;
+  }
+
   sf::Clock clock;
-  float accumulator = 0.0f;
 
   while (running_ && window_.isOpen()) {
-    input_.beginFrame();
-    processEvents();
+    profiler_.beginFrame();
+    {
+      FrameProfiler::PhaseScope phase(profiler_, FramePhase::Events);
+      input_.beginFrame();
+      processEvents();
+    }
 
-    applyPendingScene();
+    {
+      FrameProfiler::PhaseScope phase(profiler_, FramePhase::SceneSwitch);
+      applyPendingScene();
+    }
     if (!currentScene_) {
       running_ = false;
+      profiler_.endFrame();
       continue;
     }
 
-    const float frameTime = clock.restart().asSeconds();
-    accumulator += std::min(frameTime, 0.25f);
+    const unsigned ticks = timestep_.advance(clock.restart().asSeconds());
+    {
+      FrameProfiler::PhaseScope phase(profiler_, FramePhase::Update);
+      for (unsigned tick = 0; tick < ticks; ++tick) {
+        profiler_.beginTick();
+        update(timestep_.step());
+        profiler_.endTick();
+      }
+    }
+
+    render(timestep_.alpha());
+    input_.endFrame();
+    profiler_.endFrame();
+  }
+
+  window_.close();
+  saveRecording();
+  reportTimeStepStats();
+  if (profiler_.enabled()) {
+    dumpProfile();
+  }
+}
 
-    while (accumulator >= kFixedTimeStep) {
-      update(kFixedTimeStep);
-      accumulator -= kFixedTimeStep;
+void App::runLoading() {
+  // Always single-threaded: texture uploads need the window's GL context,
+  // which in pipelined mode only the main thread has.
+  sf::Clock clock;
+  while (running_ && window_.isOpen() && !loader_->done()) {
+    processEvents();
+    applyPendingScene();
+    if (!currentScene_) {
+      running_ = false;
+      break;
+    }
+
+    try {
+      update(clock.restart().asSeconds());
+    } catch (const std::exception& ex) {
+      std::cerr << "Failed to load resources: " << ex.what() << '\n';
+      throw;
     }
+    render(1.0f);
+  }
+}
+
+void App::runPipelined() {
+  window_.setFramerateLimit(0);
+  window_.setVerticalSyncEnabled(true);
+
+  std::thread simulation(&App::simulationLoop, this);
+
+  while (running_ && window_.isOpen()) {
+    profiler_.beginFrame();
+    {
+      FrameProfiler::PhaseScope phase(profiler_, FramePhase::Events);
+      processEvents();
+    }
+
+    snapshots_.acquire();
+    {
+      FrameProfiler::PhaseScope phase(profiler_, FramePhase::Render);
+      window_.clear(sf::Color(26, 26, 26));
+      snapshotRenderer_.draw(window_, snapshots_.readBuffer());
+    }
+    {
+      FrameProfiler::PhaseScope phase(profiler_, FramePhase::Present);
+      window_.display();
+    }
+    profiler_.endFrame();
+  }
+
+  running_ = false;
+  simulation.join();
+
+  window_.close();
+  saveRecording();
+  reportTimeStepStats();
+  if (profiler_.enabled()) {
+    dumpProfile();
+  }
+}
+
+void App::simulationLoop() {
+  using Clock = std::chrono::steady_clock;
+  const auto step =
+      std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(timestep_.step()));
+  const auto maxLag = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(0.25f));
+
+  std::vector<sf::Event> events;
+  auto nextTick = Clock::now();
 
-    render();
+  while (running_) {
+    {
+      std::lock_guard<std::mutex> lock(eventMutex_);
+      events.swap(pendingEvents_);
+    }
+
+    input_.beginFrame();
+    for (const auto& event : events) {
+      dispatchEvent(event);
+    }
+    events.clear();
+
+    applyPendingScene();
+    if (!currentScene_) {
+      running_ = false;
+      break;
+    }
+
+    update(timestep_.step());
     input_.endFrame();
+
+    RenderSnapshot& snapshot = snapshots_.writeBuffer();
+    snapshot.clear();
+    currentScene_->capture(snapshot);
+    snapshots_.publish();
+
+    // Catch up after short stalls; after long ones skip ahead and count the
+    // ticks that were never simulated.
+    nextTick += step;
+    const auto now = Clock::now();
+    if (now - nextTick > maxLag) {
+      timestep_.recordDroppedTicks(static_cast<std::uint64_t>((now - nextTick) / step));
+      nextTick = now;
+    }
+    std::this_thread::sleep_until(nextTick);
   }
 }
 
 void App::showReport(const OrderReport& report) {
+  saveRecording();
   requestScene([this, report]() {
     return std::make_unique<ReportScene>(*this, createContext(), report);
   });
@@ -92,10 +227,20 @@ void App::showReport(const OrderReport& report) {
 
 void App::restartSimulation() {
   requestScene([this]() {
-    return std::make_unique<CafeScene>(*this, createContext());
+    const std::uint64_t seed = beginSession();
+    if (!cafeLayout_) {
+      cafeLayout_ = CafeLayout::build(resources_, jobs_);
+    }
+    return std::make_unique<CafeScene>(*this, createContext(), dialogue_, options_.customerCount,
+                                       seed, cafeLayout_);
   });
 }
 
+void App::requestQuit() {
+  // May be called from the simulation thread; run() closes the window.
+  running_ = false;
+}
+
 ResourceManager& App::resources() {
   return resources_;
 }
@@ -123,10 +268,17 @@ void App::processEvents() {
       break;
     }
 
-    input_.handleEvent(event);
+    if (const auto* key = event.getIf<sf::Event::KeyPressed>();
+        key && key->code == sf::Keyboard::Key::F9 && profiler_.enabled()) {
+      dumpProfile();
+      continue;
+    }
 
-    if (currentScene_) {
-      currentScene_->handleEvent(event);
+    if (options_.pipelined) {
+      std::lock_guard<std::mutex> lock(eventMutex_);
+      pendingEvents_.push_back(event);
+    } else {
+      dispatchEvent(event);
     }
   }
 #else
@@ -138,31 +290,100 @@ void App::processEvents() {
       break;
     }
 
-    input_.handleEvent(event);
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F9 &&
+        profiler_.enabled()) {
+      dumpProfile();
+      continue;
+    }
 
-    if (currentScene_) {
-      currentScene_->handleEvent(event);
+    if (options_.pipelined) {
+      std::lock_guard<std::mutex> lock(eventMutex_);
+      pendingEvents_.push_back(event);
+    } else {
+      dispatchEvent(event);
     }
   }
 #endif
 }
 
+void App::dispatchEvent(const sf::Event& event) {
+  input_.handleEvent(event);
+  recorder_.record(event);
+
+  if (currentScene_) {
+    currentScene_->handleEvent(event);
+  }
+}
+
 void App::update(float dt) {
   if (currentScene_) {
     currentScene_->update(dt);
   }
+  recorder_.endTick();
 }
 
-void App::render() {
-  window_.clear(sf::Color(26, 26, 26));
+void App::render(float alpha) {
+  {
+    FrameProfiler::PhaseScope phase(profiler_, FramePhase::Render);
+    window_.clear(sf::Color(26, 26, 26));
 
-  if (currentScene_) {
-    currentScene_->draw(window_);
+    if (currentScene_) {
+      currentScene_->draw(window_, alpha);
+    }
   }
 
+  FrameProfiler::PhaseScope phase(profiler_, FramePhase::Present);
   window_.display();
 }
 
+void App::reportTimeStepStats() const {
+  const auto& stats = timestep_.stats();
+  if (stats.droppedTicks == 0 && stats.dilatedFrames == 0) {
+    return;
+  }
+  std::cout << "Simulated " << stats.ticks << " ticks at " << options_.simulationHz
+            << " Hz: dropped " << stats.droppedTicks << ", dilated frames " << stats.dilatedFrames
+            << ", max backlog " << stats.maxBacklogSeconds << "s\n";
+}
+
+void App::dumpProfile() {
+  const std::string tracePath = options_.profilePrefix + "_trace.json";
+  const std::string summaryPath = options_.profilePrefix + "_summary.csv";
+  if (!profiler_.writeChromeTrace(tracePath) ||
+      !profiler_.writeSummaryCsv(summaryPath, kFixedTimeStep)) {
+    std::cerr << "Failed to write frame profile to " << options_.profilePrefix << "_*\n";
+    return;
+  }
+  std::cout << "Wrote " << profiler_.recordedFrames() << " frames to " << tracePath << " and "
+            << summaryPath << '\n';
+}
+
+std::uint64_t App::beginSession() {
+  saveRecording();
+  const std::uint64_t seed =
+      options_.seed ? *options_.seed
+                    : (std::uint64_t{std::random_device{}()} << 32) | std::random_device{}();
+  if (!options_.recordDirectory.empty()) {
+    recorder_.begin(seed, timestep_.step(), options_.customerCount, input_.heldKeys());
+  }
+  return seed;
+}
+
+void App::saveRecording() {
+  if (!recorder_.active()) {
+    return;
+  }
+  const std::vector<std::uint8_t> bytes = recorder_.finish();
+  const std::string path = options_.recordDirectory + "/session-" +
+                           std::to_string(recordingStart_) + "-" +
+                           std::to_string(recordedSessions_++) + ".bsr";
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out.write(reinterpret_cast<const char*>(bytes.data()),
+                 static_cast<std::streamsize>(bytes.size()))) {
+    std::cerr << "Failed to write recording " << path << '\n';
+  }
+}
+
 void App::requestScene(SceneFactory factory) {
   pendingScene_ = std::move(factory);
 }
@@ -186,10 +407,11 @@ void App::applyPendingScene() {
 
 SceneContext App::createContext() {
   return SceneContext{
-      window_,
+      &window_,
       resources_,
       audio_,
       input_,
+      jobs_,
   };
 }
 
@@ -1,27 +1,84 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
 
+#include "AssetLoader.hpp"
+#include "DialogueGraph.hpp"
 #include "Audio.hpp"
+#include "FixedTimestep.hpp"
+#include "FrameProfiler.hpp"
 #include "Input.hpp"
+#include "InputRecording.hpp"
+#include "JobSystem.hpp"
+#include "RenderSnapshot.hpp"
 #include "Resources.hpp"
 #include "Scene.hpp"
+#include "TripleBuffer.hpp"
 
+class CafeLayout;
 class CafeScene;
 class ReportScene;
 struct OrderReport;
 
-class App {
+struct AppOptions {
+  // Frame profiler: keeps the last profileFrames frames and writes
+  // <profilePrefix>_trace.json / _summary.csv on exit or F9.
+  bool profile{false};
+  std::size_t profileFrames{600};
+  std::string profilePrefix{"barista-sim"};
+
+  // Runs the simulation on its own thread at kFixedTimeStep and renders the
+  // latest published RenderSnapshot on the main thread at display rate. The
+  // profiler then only sees the render thread's phases.
+  bool pipelined{false};
+
+  // Fixed simulation rate. Rendering interpolates between ticks, so this can
+  // be lowered to save CPU without visible stutter.
+  float simulationHz{60.0f};
+  TimeStepPolicy timeStepPolicy{TimeStepPolicy::CatchUp};
+  unsigned maxTicksPerFrame{15};
+
+  // Customers queueing in the café; rush-hour stress runs use thousands.
+  std::size_t customerCount{kDefaultCustomerCount};
+
+  // Sound effect voices (OpenAL sources) shared by every scene.
+  std::size_t audioVoices{AudioManager::kDefaultVoiceCount};
+
+  // Simulation worker threads besides the one running the scene.
+  unsigned workerThreads{JobSystem::kAutomatic};
+
+  // Scenario JSON for the barista (see DialogueGraph.hpp); empty runs the
+  // built-in order.
+  std::string scenarioPath;
+
+  // Writes every café session's input to <recordDirectory>/session-<start
+  // time>-<n>.bsr for headless replay (see InputRecording.hpp); empty records
+  // nothing.
+  std::string recordDirectory;
+  // Seeds each café session's random numbers; unset picks a fresh seed per
+  // session, which recordings keep.
+  std::optional<std::uint64_t> seed;
+};
+
+class App : public SceneHost {
  public:
-  App();
-  ~App();
+  explicit App(AppOptions options = {});
+  ~App() override;
 
   void run();
 
-  void showReport(const OrderReport& report);
-  void restartSimulation();
+  void showReport(const OrderReport& report) override;
+  void restartSimulation() override;
+  void requestQuit() override;
 
   ResourceManager& resources();
   AudioManager& audio();
@@ -31,21 +88,52 @@ class App {
  private:
   using SceneFactory = std::function<std::unique_ptr<Scene>()>;
 
+  void runLoading();
+  void runPipelined();
+  void simulationLoop();
+
   void processEvents();
+  void dispatchEvent(const sf::Event& event);
   void update(float dt);
-  void render();
+  void render(float alpha);
+  void dumpProfile();
+  void reportTimeStepStats() const;
+
+  // Picks the seed for the session about to start and starts recording it.
+  std::uint64_t beginSession();
+  // Writes the session being recorded, if any.
+  void saveRecording();
 
   void requestScene(SceneFactory factory);
   void applyPendingScene();
   SceneContext createContext();
 
+  AppOptions options_;
   sf::RenderWindow window_;
   ResourceManager resources_;
   AudioManager audio_;
+  // Decodes assets in the background during startup; LoadingScene drives it.
+  std::unique_ptr<AssetLoader> loader_;
   InputManager input_;
+  JobSystem jobs_;
+  DialogueGraph dialogue_;
+  // Baked by the first café session; restarts reuse it.
+  std::shared_ptr<const CafeLayout> cafeLayout_;
+  FrameProfiler profiler_;
+  FixedTimestep timestep_;
+  InputRecorder recorder_;
+  std::size_t recordedSessions_{0};
+  std::int64_t recordingStart_{0};
 
   std::unique_ptr<Scene> currentScene_;
   SceneFactory pendingScene_;
-  bool running_{true};
+  std::atomic<bool> running_{true};
+
+  // Pipelined mode: window events flow to the simulation thread through a
+  // small locked queue, snapshots flow back through the triple buffer.
+  std::mutex eventMutex_;
+  std::vector<sf::Event> pendingEvents_;
+  TripleBuffer<RenderSnapshot> snapshots_;
+  SnapshotRenderer snapshotRenderer_;
 };
 
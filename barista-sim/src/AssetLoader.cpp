@@ -0,0 +1,228 @@
+#include "AssetLoader.hpp"
+
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+
+#include "Audio.hpp"
+#include "Resources.hpp"
+
+AssetLoader::AssetLoader(ResourceManager& resources, bool includeAudio, AudioManager* music,
+                         unsigned workerCount)
+    : resources_(resources), music_(music) {
+  if (!resources_.pack()) {
+    resources_.mountPack(std::string(kDefaultAssetPackPath));
+  }
+  const AssetPack* pack = resources_.pack();
+
+  const auto addJobs = [&](const auto& manifest, Kind kind, AssetKind packKind) {
+    for (const auto& asset : manifest) {
+      const auto id = static_cast<std::uint8_t>(asset.id);
+      jobs_.push_back({kind, id, std::string(asset.path), pack ? pack->find(packKind, id) : nullptr});
+    }
+  };
+
+  // The font goes first so a loading screen can label its progress early.
+  addJobs(kFontManifest, Kind::Font, AssetKind::Font);
+  if (music_) {
+    addJobs(kMusicManifest, Kind::Music, AssetKind::Music);
+  }
+  addJobs(kTextureManifest, Kind::Texture, AssetKind::Texture);
+  if (includeAudio) {
+    addJobs(kSoundManifest, Kind::Sound, AssetKind::Sound);
+  }
+
+  ready_.reserve(jobs_.size());
+  finishing_.reserve(jobs_.size());
+
+  if (workerCount == 0) {
+    workerCount = std::max(1U, std::thread::hardware_concurrency());
+  }
+  workerCount = std::min(workerCount, static_cast<unsigned>(jobs_.size()));
+  workers_.reserve(workerCount);
+  for (unsigned i = 0; i < workerCount; ++i) {
+    workers_.emplace_back(&AssetLoader::workerLoop, this);
+  }
+}
+
+AssetLoader::~AssetLoader() {
+  // Stop handing out work; in-flight decodes still finish before join.
+  nextJob_ = jobs_.size();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void AssetLoader::pump(sf::Time budget) {
+  sf::Clock clock;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rethrowError();
+    finishing_.swap(ready_);
+  }
+
+  std::size_t next = 0;
+  for (; next < finishing_.size(); ++next) {
+    if (next > 0 && clock.getElapsedTime() >= budget) {
+      break;
+    }
+    complete(finishing_[next]);
+  }
+
+  // Whatever didn't fit goes back in front of the queue for the next pump.
+  std::lock_guard<std::mutex> lock(mutex_);
+  ready_.insert(ready_.begin(), finishing_.begin() + static_cast<std::ptrdiff_t>(next),
+                finishing_.end());
+  finishing_.clear();
+}
+
+void AssetLoader::finish() {
+  while (!done()) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      readyChanged_.wait(lock, [this] { return !ready_.empty() || !error_.empty(); });
+    }
+    pump(sf::Time::Zero);
+  }
+}
+
+bool AssetLoader::done() const {
+  return loaded_ == jobs_.size();
+}
+
+std::size_t AssetLoader::loadedCount() const {
+  return loaded_;
+}
+
+std::size_t AssetLoader::totalCount() const {
+  return jobs_.size();
+}
+
+float AssetLoader::progress() const {
+  return jobs_.empty() ? 1.0f : static_cast<float>(loaded_) / static_cast<float>(jobs_.size());
+}
+
+void AssetLoader::workerLoop() {
+  for (std::size_t index = nextJob_++; index < jobs_.size(); index = nextJob_++) {
+    try {
+      decode(index);
+    } catch (const std::exception& ex) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (error_.empty()) {
+        error_ = ex.what();
+      }
+      readyChanged_.notify_all();
+      continue;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_.push_back(index);
+    readyChanged_.notify_all();
+  }
+}
+
+void AssetLoader::decode(std::size_t index) {
+  const Job& job = jobs_[index];
+  if (job.packed) {
+    decodePacked(job);
+    return;
+  }
+
+  switch (job.kind) {
+    case Kind::Texture:
+      if (!images_[job.id].loadFromFile(job.path)) {
+        throw std::runtime_error("Failed to load texture: " + job.path);
+      }
+      break;
+    case Kind::Font:
+      if (!resources_.fonts_[job.id].loadFromFile(job.path)) {
+        throw std::runtime_error("Failed to load font: " + job.path);
+      }
+      break;
+    case Kind::Sound:
+      if (!resources_.sounds_[job.id].loadFromFile(job.path)) {
+        throw std::runtime_error("Failed to load sound: " + job.path);
+      }
+      break;
+    case Kind::Music:
+      music_->prepareMusic(static_cast<MusicId>(job.id));
+      break;
+  }
+}
+
+void AssetLoader::decodePacked(const Job& job) {
+  const PackEntry& entry = *job.packed;
+  const std::byte* data = resources_.pack()->data(entry);
+
+  switch (job.kind) {
+    case Kind::Texture: {
+      if (entry.size != std::uint64_t{entry.width} * entry.height * 4) {
+        throw std::runtime_error("Corrupt packed texture: " + job.path);
+      }
+      // Touch every page so the GL thread's upload doesn't stall on storage.
+      constexpr std::size_t kPageSize = 4096;
+      unsigned char sum = 0;
+      for (std::size_t offset = 0; offset < entry.size; offset += kPageSize) {
+        sum ^= static_cast<unsigned char>(data[offset]);
+      }
+      pageSink_.fetch_xor(sum, std::memory_order_relaxed);
+      break;
+    }
+    case Kind::Font:
+      if (!resources_.fonts_[job.id].loadFromMemory(data, entry.size)) {
+        throw std::runtime_error("Failed to load packed font: " + job.path);
+      }
+      break;
+    case Kind::Sound: {
+      const auto* samples = reinterpret_cast<const sf::Int16*>(data);
+      const std::uint64_t sampleCount = entry.size / sizeof(sf::Int16);
+      if (!resources_.sounds_[job.id].loadFromSamples(samples, sampleCount, entry.channelCount,
+                                                     entry.sampleRate)) {
+        throw std::runtime_error("Failed to load packed sound: " + job.path);
+      }
+      break;
+    }
+    case Kind::Music:
+      music_->prepareMusic(static_cast<MusicId>(job.id));
+      break;
+  }
+}
+
+void AssetLoader::complete(std::size_t index) {
+  const Job& job = jobs_[index];
+  switch (job.kind) {
+    case Kind::Texture:
+      if (job.packed) {
+        const auto* pixels =
+            reinterpret_cast<const std::uint8_t*>(resources_.pack()->data(*job.packed));
+        resources_.addTexture(static_cast<TextureId>(job.id), pixels,
+                              {job.packed->width, job.packed->height});
+      } else {
+        resources_.addTexture(static_cast<TextureId>(job.id), images_[job.id]);
+        images_[job.id] = sf::Image();
+      }
+      break;
+    case Kind::Font:
+      resources_.fontsLoaded_[job.id] = true;
+      break;
+    case Kind::Sound:
+      resources_.soundsLoaded_[job.id] = true;
+      break;
+    case Kind::Music:
+      break;
+  }
+  ++loaded_;
+}
+
+void AssetLoader::rethrowError() {
+  if (!error_.empty()) {
+    throw std::runtime_error(error_);
+  }
+}
+
+void loadDefaultAssets(ResourceManager& resources, bool includeAudio) {
+  AssetLoader loader(resources, includeAudio);
+  loader.finish();
+}
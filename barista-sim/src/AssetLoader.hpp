@@ -0,0 +1,90 @@
+#pragma once
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Time.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AssetPack.hpp"
+#include "ResourceIds.hpp"
+
+class AudioManager;
+class ResourceManager;
+
+// Loads the asset manifests in the background. Worker threads do the file
+// I/O and CPU-bound decoding (PNG to pixels, OGG to samples, font parsing);
+// the thread that owns the GL context finishes each asset in pump(), which
+// uploads textures until its time budget runs out. Fonts and sound buffers
+// are decoded straight into their ResourceManager slot, which nothing else
+// reads until pump() marks it loaded.
+//
+// When a cooked pack (kDefaultAssetPackPath) exists it is mounted first and
+// nothing is decoded: workers only fault the mapped pages in, and pixels,
+// samples and font/music bytes go from the mapping straight to SFML.
+class AssetLoader {
+ public:
+  // music, when set, also opens the ambient track on a worker so the first
+  // scene can start it without touching the disk.
+  AssetLoader(ResourceManager& resources, bool includeAudio, AudioManager* music = nullptr,
+              unsigned workerCount = 0);
+  ~AssetLoader();
+
+  AssetLoader(const AssetLoader&) = delete;
+  AssetLoader& operator=(const AssetLoader&) = delete;
+
+  // Finishes decoded assets for up to budget (always at least one). Throws
+  // std::runtime_error if a worker failed to load something.
+  void pump(sf::Time budget);
+  // Blocks until every asset is loaded.
+  void finish();
+
+  [[nodiscard]] bool done() const;
+  [[nodiscard]] std::size_t loadedCount() const;
+  [[nodiscard]] std::size_t totalCount() const;
+  [[nodiscard]] float progress() const;
+
+ private:
+  enum class Kind : std::uint8_t { Texture, Font, Sound, Music };
+
+  struct Job {
+    Kind kind;
+    std::uint8_t id;
+    std::string path;
+    const PackEntry* packed;
+  };
+
+  void workerLoop();
+  void decode(std::size_t index);
+  void decodePacked(const Job& job);
+  void complete(std::size_t index);
+  void rethrowError();
+
+  ResourceManager& resources_;
+  AudioManager* music_;
+  std::vector<Job> jobs_;
+  std::array<sf::Image, kResourceCount<TextureId>> images_;
+
+  std::atomic<std::size_t> nextJob_{0};
+  // Keeps the page-touching reads in decodePacked() from being optimized out.
+  std::atomic<unsigned char> pageSink_{0};
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable readyChanged_;
+  std::vector<std::size_t> ready_;
+  std::vector<std::size_t> finishing_;
+  std::string error_;
+
+  std::size_t loaded_{0};
+};
+
+// Loads everything in the texture and font manifests, plus the sound
+// manifest when includeAudio is set, and waits for it.
+void loadDefaultAssets(ResourceManager& resources, bool includeAudio);
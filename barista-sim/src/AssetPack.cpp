@@ -0,0 +1,123 @@
+#include "AssetPack.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+[[noreturn]] void throwInvalid(const std::string& path, const char* reason) {
+  throw std::runtime_error("Invalid asset pack " + path + ": " + reason +
+                           " (re-run barista-sim-cook)");
+}
+}  // namespace
+
+std::unique_ptr<AssetPack> AssetPack::open(const std::string& path) {
+  std::unique_ptr<AssetPack> pack(new AssetPack());
+
+#if defined(_WIN32)
+  pack->file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (pack->file_ == INVALID_HANDLE_VALUE) {
+    pack->file_ = nullptr;
+    return nullptr;
+  }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(pack->file_, &fileSize) || fileSize.QuadPart == 0) {
+    throwInvalid(path, "empty file");
+  }
+  pack->size_ = static_cast<std::size_t>(fileSize.QuadPart);
+  pack->mapping_ = CreateFileMappingA(pack->file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!pack->mapping_) {
+    throw std::runtime_error("Failed to map asset pack: " + path);
+  }
+  pack->base_ = static_cast<const std::byte*>(MapViewOfFile(pack->mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (!pack->base_) {
+    throw std::runtime_error("Failed to map asset pack: " + path);
+  }
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    throwInvalid(path, "empty file");
+  }
+  pack->size_ = static_cast<std::size_t>(info.st_size);
+  void* mapped = ::mmap(nullptr, pack->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    throw std::runtime_error("Failed to map asset pack: " + path);
+  }
+  pack->base_ = static_cast<const std::byte*>(mapped);
+#endif
+
+  if (pack->size_ < sizeof(PackHeader)) {
+    throwInvalid(path, "truncated header");
+  }
+  PackHeader header;
+  std::memcpy(&header, pack->base_, sizeof(header));
+  if (std::memcmp(header.magic, kAssetPackMagic, sizeof(header.magic)) != 0) {
+    throwInvalid(path, "bad magic");
+  }
+  if (header.version != kAssetPackVersion) {
+    throwInvalid(path, "unsupported version");
+  }
+  if ((pack->size_ - sizeof(PackHeader)) / sizeof(PackEntry) < header.entryCount) {
+    throwInvalid(path, "truncated table of contents");
+  }
+
+  pack->entries_ = reinterpret_cast<const PackEntry*>(pack->base_ + sizeof(PackHeader));
+  pack->entryCount_ = header.entryCount;
+  for (std::uint32_t i = 0; i < pack->entryCount_; ++i) {
+    const PackEntry& entry = pack->entries_[i];
+    if (entry.offset > pack->size_ || entry.size > pack->size_ - entry.offset) {
+      throwInvalid(path, "entry out of bounds");
+    }
+  }
+  return pack;
+}
+
+AssetPack::~AssetPack() {
+#if defined(_WIN32)
+  if (base_) {
+    UnmapViewOfFile(base_);
+  }
+  if (mapping_) {
+    CloseHandle(mapping_);
+  }
+  if (file_) {
+    CloseHandle(file_);
+  }
+#else
+  if (base_) {
+    ::munmap(const_cast<std::byte*>(base_), size_);
+  }
+#endif
+}
+
+const PackEntry* AssetPack::find(AssetKind kind, std::uint8_t id) const {
+  for (std::uint32_t i = 0; i < entryCount_; ++i) {
+    if (entries_[i].kind == kind && entries_[i].id == id) {
+      return &entries_[i];
+    }
+  }
+  return nullptr;
+}
+
+const std::byte* AssetPack::data(const PackEntry& entry) const {
+  return base_ + entry.offset;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Cooked asset pack written by barista-sim-cook. Layout (little-endian):
+//
+//   PackHeader
+//   PackEntry[entryCount]        table of contents
+//   blobs, each 16-byte aligned  RGBA8 pixels, raw font files, interleaved
+//                                16-bit PCM for sound effects, raw OGG for
+//                                streamed music
+//
+// At runtime the file is memory-mapped and blobs are handed to SFML in place.
+
+inline constexpr char kAssetPackMagic[4] = {'B', 'S', 'P', 'K'};
+inline constexpr std::uint32_t kAssetPackVersion = 1;
+inline constexpr std::size_t kAssetPackAlignment = 16;
+inline constexpr std::string_view kDefaultAssetPackPath = "assets.pak";
+
+enum class AssetKind : std::uint8_t { Texture = 1, Font = 2, Sound = 3, Music = 4 };
+
+struct PackHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t entryCount;
+  std::uint32_t reserved;
+};
+
+struct PackEntry {
+  AssetKind kind;
+  std::uint8_t id;              // TextureId, FontId, SoundId or MusicId
+  std::uint16_t channelCount;   // sounds
+  std::uint32_t width;          // textures
+  std::uint32_t height;         // textures
+  std::uint32_t sampleRate;     // sounds
+  std::uint64_t offset;         // from the start of the file
+  std::uint64_t size;           // bytes
+};
+
+static_assert(sizeof(PackHeader) == 16 && std::is_trivially_copyable_v<PackHeader>);
+static_assert(sizeof(PackEntry) == 32 && std::is_trivially_copyable_v<PackEntry>);
+
+// Read-only memory mapping of a pack. Blob pointers stay valid for the
+// lifetime of the object.
+class AssetPack {
+ public:
+  // Returns null when the file does not exist; throws std::runtime_error
+  // when it exists but is not a valid pack of this version.
+  [[nodiscard]] static std::unique_ptr<AssetPack> open(const std::string& path);
+  ~AssetPack();
+
+  AssetPack(const AssetPack&) = delete;
+  AssetPack& operator=(const AssetPack&) = delete;
+
+  [[nodiscard]] const PackEntry* find(AssetKind kind, std::uint8_t id) const;
+  [[nodiscard]] const std::byte* data(const PackEntry& entry) const;
+
+ private:
+  AssetPack() = default;
+
+  const std::byte* base_{nullptr};
+  std::size_t size_{0};
+  const PackEntry* entries_{nullptr};
+  std::uint32_t entryCount_{0};
+#if defined(_WIN32)
+  void* file_{nullptr};
+  void* mapping_{nullptr};
+#endif
+};
@@ -1,22 +1,85 @@
 #include <algorithm>
 #include "Audio.hpp"
 
+#include "AssetPack.hpp"
 #include "Resources.hpp"
 
 #include <SFML/Config.hpp>
 #include <stdexcept>
+#include <string>
 
-AudioManager::SoundEntry::SoundEntry(const sf::SoundBuffer& buffer, float volume)
-    : sound(buffer), baseVolume(volume) {}
+namespace {
+[[nodiscard]] bool isPlaying(const sf::Sound& sound) {
+  return sound.getStatus() != sf::Sound::Status::Stopped;
+}
+}  // namespace
+
+AudioManager::SoundSettingsTable AudioManager::defaultSoundSettings() {
+  SoundSettingsTable settings{};
+  // UI feedback outranks footsteps, so a crowd never swallows a click.
+  settings[indexOf(SoundId::Ding)] = {3, 2};
+  settings[indexOf(SoundId::UiClick)] = {2, 4};
+  settings[indexOf(SoundId::Step)] = {0, 12};
+  return settings;
+}
 
-void AudioManager::setResources(ResourceManager* resources) {
+void AudioManager::setResources(const ResourceManager* resources) {
   resources_ = resources;
 }
 
-void AudioManager::playMusic(const std::string& path, bool loop, float volume) {
-  if (!music_.openFromFile(path)) {
+void AudioManager::setVoiceCount(std::size_t count) {
+  voices_.clear();
+  voices_.resize(count);
+}
+
+std::size_t AudioManager::voiceCount() const {
+  return voices_.size();
+}
+
+std::size_t AudioManager::activeVoices() const {
+  return static_cast<std::size_t>(std::count_if(
+      voices_.begin(), voices_.end(), [](const Voice& voice) { return isPlaying(voice.sound); }));
+}
+
+void AudioManager::setSoundSettings(SoundId id, SoundSettings settings) {
+  settings.maxInstances = std::max<std::uint8_t>(settings.maxInstances, 1);
+  settings_[indexOf(id)] = settings;
+}
+
+const SoundSettings& AudioManager::soundSettings(SoundId id) const {
+  return settings_[indexOf(id)];
+}
+
+void AudioManager::setEnabled(bool enabled) {
+  enabled_ = enabled;
+}
+
+bool AudioManager::enabled() const {
+  return enabled_;
+}
+
+void AudioManager::prepareMusic(MusicId id) {
+  if (!enabled_ || preparedMusic_ == id) {
+    return;
+  }
+  preparedMusic_.reset();
+
+  const AssetPack* pack = resources_ ? resources_->pack() : nullptr;
+  const PackEntry* entry = pack ? pack->find(AssetKind::Music, static_cast<std::uint8_t>(id)) : nullptr;
+  const std::string path(manifestPath(kMusicManifest, id));
+  const bool opened = entry ? music_.openFromMemory(pack->data(*entry), entry->size)
+                            : music_.openFromFile(path);
+  if (!opened) {
     throw std::runtime_error("Failed to open music: " + path);
   }
+  preparedMusic_ = id;
+}
+
+void AudioManager::playMusic(MusicId id, bool loop, float volume) {
+  if (!enabled_) {
+    return;
+  }
+  prepareMusic(id);
 #if SFML_VERSION_MAJOR >= 3
   music_.setLooping(loop);
 #else
@@ -31,28 +94,73 @@ void AudioManager::stopMusic() {
   music_.stop();
 }
 
-void AudioManager::playSound(const std::string& bufferId, float volume) {
-  if (!resources_) {
+void AudioManager::playSound(SoundId id, float volume) {
+  if (!enabled_ || !resources_ || voices_.empty()) {
+    return;
+  }
+
+  const SoundSettings& settings = settings_[indexOf(id)];
+  Voice* voice = pickVoice(id, settings);
+  if (!voice) {
     return;
   }
 
-  const auto& buffer = resources_->soundBuffer(bufferId);
-  auto [it, inserted] = sounds_.try_emplace(bufferId, buffer, volume);
-  auto& entry = it->second;
-  if (!inserted) {
-    entry.baseVolume = volume;
-    entry.sound.stop();
-    entry.sound.setBuffer(buffer);
+  const auto& buffer = resources_->soundBuffer(id);
+  voice->sound.stop();
+  if (voice->sound.getBuffer() != &buffer) {
+    voice->sound.setBuffer(buffer);
+  }
+  voice->id = id;
+  voice->priority = settings.priority;
+  voice->baseVolume = volume;
+  voice->startedAt = ++playCounter_;
+  voice->sound.setVolume(voice->baseVolume * (masterVolume_ / 100.0f));
+  voice->sound.play();
+}
+
+AudioManager::Voice* AudioManager::pickVoice(SoundId id, const SoundSettings& settings) {
+  Voice* free = nullptr;
+  Voice* oldestSame = nullptr;
+  Voice* victim = nullptr;
+  std::size_t instances = 0;
+
+  for (auto& voice : voices_) {
+    if (!isPlaying(voice.sound)) {
+      if (!free) {
+        free = &voice;
+      }
+      continue;
+    }
+
+    if (voice.id == id) {
+      ++instances;
+      if (!oldestSame || voice.startedAt < oldestSame->startedAt) {
+        oldestSame = &voice;
+      }
+    }
+
+    if (voice.priority > settings.priority) {
+      continue;
+    }
+    if (!victim || voice.priority < victim->priority ||
+        (voice.priority == victim->priority &&
+         (voice.baseVolume < victim->baseVolume ||
+          (voice.baseVolume == victim->baseVolume && voice.startedAt < victim->startedAt)))) {
+      victim = &voice;
+    }
+  }
+
+  if (instances >= settings.maxInstances) {
+    return oldestSame;
   }
-  entry.sound.setVolume(entry.baseVolume * (masterVolume_ / 100.0f));
-  entry.sound.play();
+  return free ? free : victim;
 }
 
 void AudioManager::setMasterVolume(float volume) {
   masterVolume_ = std::clamp(volume, 0.0f, 100.0f);
   music_.setVolume(musicBaseVolume_ * (masterVolume_ / 100.0f));
-  for (auto& [_, entry] : sounds_) {
-    entry.sound.setVolume(entry.baseVolume * (masterVolume_ / 100.0f));
+  for (auto& voice : voices_) {
+    voice.sound.setVolume(voice.baseVolume * (masterVolume_ / 100.0f));
   }
 }
 
@@ -2,33 +2,81 @@
 
 #include <SFML/Audio/Music.hpp>
 #include <SFML/Audio/Sound.hpp>
-#include <string>
-#include <unordered_map>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "ResourceIds.hpp"
 
 class ResourceManager;
 
+// How a sound competes for voices. Higher priorities may steal voices from
+// lower ones; a sound already playing maxInstances times restarts its own
+// oldest instance instead of taking another voice.
+struct SoundSettings {
+  std::uint8_t priority{0};
+  std::uint8_t maxInstances{4};
+};
+
+// Sound effects play on a fixed pool of preallocated voices (one OpenAL
+// source each), so overlapping cues don't cut each other off and playSound()
+// never allocates. When the pool is full, the new sound steals the voice
+// with the lowest priority, then the quietest, then the oldest; if every
+// voice outranks it, the new sound is dropped.
 class AudioManager {
  public:
-  void setResources(ResourceManager* resources);
+  static constexpr std::size_t kDefaultVoiceCount = 32;
+
+  void setResources(const ResourceManager* resources);
+
+  // Allocates the voice pool. Until this is called sounds are silent, which
+  // keeps headless runs from creating OpenAL sources.
+  void setVoiceCount(std::size_t count);
+  [[nodiscard]] std::size_t voiceCount() const;
+  [[nodiscard]] std::size_t activeVoices() const;
 
-  void playMusic(const std::string& path, bool loop = true, float volume = 50.0f);
+  void setSoundSettings(SoundId id, SoundSettings settings);
+  [[nodiscard]] const SoundSettings& soundSettings(SoundId id) const;
+
+  // Disabled managers swallow every request; used by headless runs.
+  void setEnabled(bool enabled);
+  [[nodiscard]] bool enabled() const;
+
+  // Opens the stream without playing it, so a later playMusic() of the same
+  // track skips the open and header decode. Streams from the mounted asset
+  // pack when it has the track, else from the manifest file. Safe to call
+  // from a loader thread while nothing else uses the manager.
+  void prepareMusic(MusicId id);
+  void playMusic(MusicId id, bool loop = true, float volume = 50.0f);
   void stopMusic();
 
-  void playSound(const std::string& bufferId, float volume = 100.0f);
+  void playSound(SoundId id, float volume = 100.0f);
   void setMasterVolume(float volume);
   [[nodiscard]] float masterVolume() const;
 
  private:
-  ResourceManager* resources_{nullptr};
-  struct SoundEntry {
-    SoundEntry(const sf::SoundBuffer& buffer, float volume);
-
+  const ResourceManager* resources_{nullptr};
+  bool enabled_{true};
+  struct Voice {
     sf::Sound sound;
+    SoundId id{SoundId::Count};
+    std::uint8_t priority{0};
     float baseVolume{100.0f};
+    std::uint64_t startedAt{0};
   };
 
+  using SoundSettingsTable = std::array<SoundSettings, kResourceCount<SoundId>>;
+
+  [[nodiscard]] static SoundSettingsTable defaultSoundSettings();
+  [[nodiscard]] Voice* pickVoice(SoundId id, const SoundSettings& settings);
+
   sf::Music music_;
-  std::unordered_map<std::string, SoundEntry> sounds_;
+  std::optional<MusicId> preparedMusic_;
+  std::vector<Voice> voices_;
+  SoundSettingsTable settings_{defaultSoundSettings()};
+  std::uint64_t playCounter_{0};
   float masterVolume_{100.0f};
   float musicBaseVolume_{50.0f};
 };
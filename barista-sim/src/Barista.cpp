@@ -2,62 +2,38 @@
 
 #include <stdexcept>
 
-Barista::Barista(MenuOptions menu) : menu_(std::move(menu)) {}
+namespace {
+// Room for a long line with every field quoted; a longer prompt grows the
+// buffer once and keeps it.
+constexpr std::size_t kPromptReserve = 512;
+}  // namespace
+
+Barista::Barista(const DialogueGraph& dialogue) : dialogue_(&dialogue) {
+  promptBuffer_.reserve(kPromptReserve);
+}
 
 void Barista::startConversation() {
-  order_.reset();
-  state_ = State::AskDrink;
-  updatePromptAndOptions();
+  dispatch(Event::Start, 0, {});
 }
 
 void Barista::resetConversation() {
-  state_ = State::Idle;
-  options_.clear();
-  prompt_.clear();
-  order_.reset();
+  dispatch(Event::Reset, 0, {});
 }
 
 void Barista::selectOption(std::size_t index) {
-  if (state_ == State::AskDrink) {
-    if (index >= menu_.drinks.size()) {
-      throw std::out_of_range("Invalid drink option");
-    }
-    order_.drink = menu_.drinks[index];
-    state_ = State::AskSize;
-  } else if (state_ == State::AskSize) {
-    if (index >= menu_.sizes.size()) {
-      throw std::out_of_range("Invalid size option");
-    }
-    order_.size = menu_.sizes[index];
-    state_ = State::AskMilk;
-  } else if (state_ == State::AskMilk) {
-    if (index >= menu_.milks.size()) {
-      throw std::out_of_range("Invalid milk option");
-    }
-    order_.milk = menu_.milks[index];
-    state_ = State::AskName;
-  } else if (state_ == State::Confirm) {
-    state_ = State::Complete;
-  }
-
-  updatePromptAndOptions();
+  dispatch(Event::Choose, index, {});
 }
 
-void Barista::submitName(const std::string& name) {
-  if (state_ != State::AskName) {
-    return;
-  }
-  order_.customerName = name;
-  state_ = State::Confirm;
-  finalizeOrder();
+void Barista::submitName(std::string_view name) {
+  dispatch(Event::Name, 0, name);
 }
 
-const std::string& Barista::prompt() const {
+std::string_view Barista::prompt() const {
   return prompt_;
 }
 
-const std::vector<std::string>& Barista::options() const {
-  return options_;
+std::span<const std::string_view> Barista::options() const {
+  return std::span<const std::string_view>(options_.data(), optionCount_);
 }
 
 bool Barista::requiresInput() const {
@@ -76,63 +52,102 @@ Barista::State Barista::state() const {
   return state_;
 }
 
-void Barista::advanceState() {
-  switch (state_) {
-    case State::AskDrink:
-      state_ = State::AskSize;
-      break;
-    case State::AskSize:
-      state_ = State::AskMilk;
-      break;
-    case State::AskMilk:
-      state_ = State::AskName;
-      break;
-    case State::AskName:
-      state_ = State::Confirm;
-      break;
-    case State::Confirm:
-      state_ = State::Complete;
-      break;
-    default:
-      break;
+const DialogueGraph& Barista::dialogue() const {
+  return *dialogue_;
+}
+
+void Barista::dispatch(Event event, std::size_t option, std::string_view name) {
+  const DialogueGraph::Node& node = dialogue_->node(node_);
+  switch (kTransitions[static_cast<std::size_t>(state_)][static_cast<std::size_t>(event)]) {
+    case Action::Ignore:
+      return;
+    case Action::Start:
+      order_.reset();
+      enter(0);
+      return;
+    case Action::FollowOption: {
+      const auto options = dialogue_->options(node);
+      if (option >= options.size()) {
+        throw std::out_of_range("Invalid dialogue option");
+      }
+      if (node.slot != DialogueGraph::Slot::None) {
+        order_.choose(DialogueGraph::field(node.slot), static_cast<std::uint8_t>(option));
+      }
+      if (options[option].next != DialogueGraph::kNoNode) {
+        enter(options[option].next);
+      }
+      return;
+    }
+    case Action::FollowName:
+      order_.setCustomerName(name);
+      enter(node.next);
+      return;
+    case Action::Reset:
+      state_ = State::Idle;
+      node_ = 0;
+      prompt_ = {};
+      optionCount_ = 0;
+      order_.reset();
+      return;
   }
 }
 
-void Barista::updatePromptAndOptions() {
-  options_.clear();
+void Barista::enter(DialogueGraph::NodeId node) {
+  node_ = node;
+  const DialogueGraph::Node& current = dialogue_->node(node);
+  if (node + 1 == dialogue_->nodeCount()) {
+    state_ = State::Complete;
+  } else if (current.slot == DialogueGraph::Slot::Name) {
+    state_ = State::AskName;
+  } else if (node >= dialogue_->closingNode()) {
+    state_ = State::Confirm;
+  } else {
+    state_ = State::Ask;
+  }
 
-  switch (state_) {
-    case State::AskDrink:
-      prompt_ = "Welcome! What can I get started for you?";
-      options_ = menu_.drinks;
-      break;
-    case State::AskSize:
-      prompt_ = "Great choice! What size would you like?";
-      options_ = menu_.sizes;
-      break;
-    case State::AskMilk:
-      prompt_ = "Any milk preference today?";
-      options_ = menu_.milks;
-      break;
-    case State::AskName:
-      prompt_ = "Perfect. Name for the order?";
-      break;
-    case State::Confirm:
-      finalizeOrder();
-      break;
-    case State::Complete:
-      prompt_ = "Your order is on its way! Feel free to take a seat.";
-      options_.push_back("Thanks!");
-      break;
-    default:
-      break;
+  resolvePrompt(dialogue_->text(current.prompt));
+  const auto options = dialogue_->options(current);
+  optionCount_ = options.size();
+  for (std::size_t i = 0; i < optionCount_; ++i) {
+    options_[i] = dialogue_->text(options[i].label);
   }
 }
 
-void Barista::finalizeOrder() {
-  prompt_ = "Awesome! A " + order_.size + " " + order_.drink + " with " + order_.milk +
-            " for " + order_.customerName + ".";
-  options_.clear();
-  options_.push_back("Sounds great!");
+void Barista::resolvePrompt(std::string_view text) {
+  if (text.find('{') == std::string_view::npos) {
+    prompt_ = text;
+    return;
+  }
+
+  promptBuffer_.clear();
+  while (!text.empty()) {
+    const std::size_t open = text.find('{');
+    const std::size_t close = text.find('}', open);
+    if (open == std::string_view::npos || close == std::string_view::npos) {
+      break;
+    }
+    promptBuffer_.append(text.substr(0, open));
+    const std::string_view field = text.substr(open + 1, close - open - 1);
+    if (field == "drink") {
+      appendItem(DialogueGraph::Slot::Drink, order_.drink);
+    } else if (field == "size") {
+      appendItem(DialogueGraph::Slot::Size, order_.size);
+    } else if (field == "milk") {
+      appendItem(DialogueGraph::Slot::Milk, order_.milk);
+    } else if (field == "name") {
+      promptBuffer_.append(order_.customerName());
+    } else {
+      promptBuffer_.append(text.substr(open, close - open + 1));
+    }
+    text.remove_prefix(close + 1);
+  }
+  promptBuffer_.append(text);
+  prompt_ = promptBuffer_;
 }
 
+void Barista::appendItem(DialogueGraph::Slot slot, std::uint8_t item) {
+  const auto menu = dialogue_->menu(slot);
+  if (order_.has(DialogueGraph::field(slot)) && item < menu.size()) {
+    promptBuffer_.append(dialogue_->text(menu[item].label));
+  }
+}
@@ -1,47 +1,75 @@
 #pragma once
 
-#include "NPC.hpp"
+#include "DialogueGraph.hpp"
 #include "Order.hpp"
 
+#include <array>
+#include <cstdint>
+#include <span>
 #include <string>
-#include <vector>
+#include <string_view>
 
-class Barista : public NPC {
+// The barista's side of the ordering conversation, walking a scenario's
+// DialogueGraph. Its sprite is a World entity owned by the scene.
+//
+// What each state does with each event is a constexpr table; the graph node
+// reached decides the next state. Options are views into the graph's strings
+// and the prompt is resolved into a buffer reserved up front, so moving
+// through the conversation does not allocate.
+class Barista {
  public:
-  enum class State {
+  enum class State : std::uint8_t {
     Idle,
-    AskDrink,
-    AskSize,
-    AskMilk,
-    AskName,
-    Confirm,
+    Ask,       // choosing an option
+    AskName,   // typing a name
+    Confirm,   // every question answered; Enter completes the order
     Complete
   };
 
-  explicit Barista(MenuOptions menu);
+  // dialogue must outlive the barista.
+  explicit Barista(const DialogueGraph& dialogue);
 
   void startConversation();
   void resetConversation();
 
   void selectOption(std::size_t index);
-  void submitName(const std::string& name);
+  void submitName(std::string_view name);
 
-  [[nodiscard]] const std::string& prompt() const;
-  [[nodiscard]] const std::vector<std::string>& options() const;
+  // Valid until the next call that changes the conversation.
+  [[nodiscard]] std::string_view prompt() const;
+  [[nodiscard]] std::span<const std::string_view> options() const;
   [[nodiscard]] bool requiresInput() const;
   [[nodiscard]] bool isConversationActive() const;
   [[nodiscard]] const Order& order() const;
   [[nodiscard]] State state() const;
+  [[nodiscard]] const DialogueGraph& dialogue() const;
 
  private:
-  void advanceState();
-  void updatePromptAndOptions();
-  void finalizeOrder();
+  enum class Event : std::uint8_t { Start, Choose, Name, Reset };
+  enum class Action : std::uint8_t { Ignore, Start, FollowOption, FollowName, Reset };
 
-  MenuOptions menu_;
+  // Rows are states, columns events.
+  static constexpr std::array<std::array<Action, 4>, 5> kTransitions{{
+      /* Idle     */ {Action::Start, Action::Ignore, Action::Ignore, Action::Reset},
+      /* Ask      */ {Action::Start, Action::FollowOption, Action::Ignore, Action::Reset},
+      /* AskName  */ {Action::Start, Action::Ignore, Action::FollowName, Action::Reset},
+      /* Confirm  */ {Action::Start, Action::FollowOption, Action::Ignore, Action::Reset},
+      /* Complete */ {Action::Start, Action::Ignore, Action::Ignore, Action::Reset},
+  }};
+
+  void dispatch(Event event, std::size_t option, std::string_view name);
+  void enter(DialogueGraph::NodeId node);
+  // The node's text with {drink}, {size}, {milk} and {name} filled in.
+  void resolvePrompt(std::string_view text);
+  // The menu label of an order field, or nothing while it is unset.
+  void appendItem(DialogueGraph::Slot slot, std::uint8_t item);
+
+  const DialogueGraph* dialogue_;
+  DialogueGraph::NodeId node_{0};
   Order order_;
   State state_{State::Idle};
-  std::string prompt_;
-  std::vector<std::string> options_;
+  std::string promptBuffer_;
+  std::string_view prompt_;
+  std::array<std::string_view, DialogueGraph::kMaxOptions> options_{};
+  std::size_t optionCount_{0};
 };
-
@@ -3,17 +3,19 @@
 #include <SFML/Config.hpp>
 #include <SFML/Window/Keyboard.hpp>
 #include <algorithm>
+#include <array>
+#include <utility>
 
-#include "App.hpp"
 #include "Audio.hpp"
+#include "JobSystem.hpp"
 #include "Order.hpp"
+#include "RenderSnapshot.hpp"
 #include "ReportScene.hpp"
 #include "Resources.hpp"
+#include "Systems.hpp"
 #include "Utils.hpp"
 
 namespace {
-const char* kAmbientTrack = "assets/audio/ambience.ogg";
-
 bool isPrintable(sf::Uint32 code) {
   return code >= 32 && code <= 126;
 }
@@ -24,29 +26,144 @@ std::string toPrintableString(const std::string& source, std::size_t maxLength)
   }
   return source.substr(0, maxLength);
 }
+
+// Gap between two boxes, zero when they overlap. The counter collider keeps
+// the player's centre ~140 px from the barista, so reach is measured edge to
+// edge rather than centre to centre.
+float boundsGap(const sf::FloatRect& a, const sf::FloatRect& b) {
+  const float dx = std::max({0.0f, b.left - (a.left + a.width), a.left - (b.left + b.width)});
+  const float dy = std::max({0.0f, b.top - (a.top + a.height), a.top - (b.top + b.height)});
+  return utils::length({dx, dy});
+}
+
+// Scales a sprite to a fixed on-screen size. The texture rect comes from the
+// probed texture size so headless runs, whose textures stay empty, still get
+// real bounds for collisions.
+sf::Sprite makeScaledSprite(const ResourceManager& resources, TextureId id,
+                            const sf::Vector2f& size, const sf::Vector2f& originFactor) {
+  sf::Sprite sprite(resources.texture(id));
+  const auto textureSize = resources.textureSize(id);
+  sprite.setTextureRect(
+      sf::IntRect(0, 0, static_cast<int>(textureSize.x), static_cast<int>(textureSize.y)));
+  sprite.setOrigin(static_cast<float>(textureSize.x) * originFactor.x,
+                   static_cast<float>(textureSize.y) * originFactor.y);
+  if (textureSize.x > 0 && textureSize.y > 0) {
+    sprite.setScale(size.x / static_cast<float>(textureSize.x),
+                    size.y / static_cast<float>(textureSize.y));
+  }
+  return sprite;
+}
+
+constexpr float kNavCellSize = 16.0f;
+const sf::Vector2f kPlayerSize{72.0f, 120.0f};
+
+const std::array<sf::Vector2f, 3> kCounterSlots = {{
+    {720.0f, 420.0f},
+    {780.0f, 470.0f},
+    {840.0f, 520.0f},
+}};
+
+// Where customer i enters and where it queues. The first three stand at the
+// counter; stress runs with more customers extend the queue in rows of 16
+// down past the door, spaced wider than the separation distance.
+std::array<sf::Vector2f, 2> customerDoorAndSlot(std::size_t i) {
+  if (i < kCounterSlots.size()) {
+    return {sf::Vector2f{1100.0f + static_cast<float>(i) * 40.0f, 710.0f}, kCounterSlots[i]};
+  }
+
+  constexpr std::size_t kRowLength = 16;
+  constexpr float kSpacing = 44.0f;
+  const std::size_t slot = i - kCounterSlots.size();
+  const sf::Vector2f target{560.0f + static_cast<float>(slot % kRowLength) * kSpacing,
+                            580.0f + static_cast<float>(slot / kRowLength) * kSpacing};
+  return {target + sf::Vector2f{0.0f, 150.0f}, target};
+}
 }  // namespace
 
-CafeScene::CafeScene(App& app, SceneContext context)
-    : Scene(app, context),
-      barista_({{"Latte", "Americano", "Cappuccino", "Mocha"},
-                {"Small", "Medium", "Large"},
-                {"Whole Milk", "Oat Milk", "Almond Milk", "No Milk"}}) {
+std::shared_ptr<const CafeLayout> CafeLayout::build(const ResourceManager& resources,
+                                                     JobSystem& jobs) {
+  std::shared_ptr<CafeLayout> layout(new CafeLayout());
+  layout->colliders_ = {
+      {0.0f, 180.0f, 1280.0f, 160.0f},  // Counter row
+      {120.0f, 360.0f, 240.0f, 120.0f},  // Tables
+      {420.0f, 380.0f, 160.0f, 120.0f},
+      {980.0f, 360.0f, 200.0f, 140.0f},
+  };
+
+  // Navigation covers the visible floor; stress customers queueing beyond it
+  // walk straight in. Customers only need clearance around their feet; they
+  // all head for the counter, so they share one flow field instead of
+  // solving a path each. The two grids bake side by side on jobs, and the
+  // flow field follows once the customer grid is ready.
+  const sf::FloatRect floor(0.0f, 0.0f, 1280.0f, 720.0f);
+  const sf::FloatRect playerBounds =
+      makeScaledSprite(resources, TextureId::Player, kPlayerSize, {0.5f, 0.5f}).getGlobalBounds();
+  CafeLayout& baking = *layout;
+  const auto bakePlayerGrid = [&] {
+    baking.playerGrid_.bake(floor, kNavCellSize, baking.colliders_,
+                            {playerBounds.width * 0.5f, playerBounds.height * 0.5f});
+  };
+  const auto bakeCustomerGrid = [&] {
+    baking.customerGrid_.bake(floor, kNavCellSize, baking.colliders_, {16.0f, 8.0f});
+  };
+  const auto buildCounterFlow = [&] {
+    baking.counterFlow_.build(baking.customerGrid_, kCounterSlots);
+  };
+  JobCounter customerGridBaked;
+  JobCounter navigationReady;
+  jobs.submit(customerGridBaked, bakeCustomerGrid);
+  jobs.submit(navigationReady, bakePlayerGrid);
+  jobs.submit(navigationReady, buildCounterFlow, &customerGridBaked);
+  jobs.wait(navigationReady);
+  jobs.wait(customerGridBaked);
+  return layout;
+}
+
+std::span<const sf::FloatRect> CafeLayout::colliders() const {
+  return colliders_;
+}
+
+const NavGrid& CafeLayout::playerGrid() const {
+  return playerGrid_;
+}
+
+const NavGrid& CafeLayout::customerGrid() const {
+  return customerGrid_;
+}
+
+const FlowField& CafeLayout::counterFlow() const {
+  return counterFlow_;
+}
+
+CafeScene::CafeScene(SceneHost& host, SceneContext context, const DialogueGraph& dialogue,
+                     std::size_t customerCount, std::uint64_t seed,
+                     std::shared_ptr<const CafeLayout> layout)
+    : Scene(host, context),
+      barista_(dialogue),
+      random_(seed),
+      layout_(layout ? std::move(layout) : CafeLayout::build(context.resources, context.jobs)) {
   dialogue_.initialize(context.resources);
   hud_.initialize(context.resources);
-  setupWorld();
+  setupWorld(customerCount);
 }
 
 void CafeScene::onEnter() {
-  context().audio.playMusic(kAmbientTrack, true, 35.0f);
+  context().audio.playMusic(MusicId::Ambience, true, 35.0f);
   inConversation_ = false;
   nameBuffer_.clear();
   idleTimer_ = 0.0f;
   penaltyTriggered_ = false;
   penaltyTime_ = 0.0f;
   totalElapsed_ = 0.0f;
+  walkingToBarista_ = false;
+  player_.stopWalking();
   player_.resetStats();
   dialogue_.setVisible(false);
   hud_.clearHint();
+  const DialogueGraph& scenario = barista_.dialogue();
+  if (!scenario.setting().empty()) {
+    hud_.setHint(std::string(scenario.title()) + ": " + std::string(scenario.setting()));
+  }
 }
 
 void CafeScene::onExit() {
@@ -56,15 +173,16 @@ void CafeScene::onExit() {
 void CafeScene::handleEvent(const sf::Event& event) {
   auto handleKeyPress = [&](sf::Keyboard::Key key) {
     if (key == sf::Keyboard::Escape) {
-      app().window().close();
+      host().requestQuit();
       return;
     }
 
     if (!inConversation_) {
       if (key == sf::Keyboard::E) {
-        const float distance = utils::distance(player_.position(), barista_.position());
-        if (distance <= player_.interactionRadius()) {
+        if (baristaInReach()) {
           beginConversation();
+        } else {
+          walkToBarista();
         }
       }
     } else {
@@ -124,9 +242,17 @@ void CafeScene::handleEvent(const sf::Event& event) {
 void CafeScene::update(float dt) {
   totalElapsed_ += dt;
 
+  beginTick(world_);
+  customers_.beginTick();
+
   const sf::Vector2f previous = player_.position();
-  player_.update(dt, context().input, context().audio);
+  player_.applyInput(context().input);
+  integrateVelocities(world_, dt);
+  followPaths(world_, dt);
+  animateIdle(world_, dt);
+  player_.afterMove(dt, context().audio);
   updateCollisions(previous);
+  updateWalkToBarista();
 
   updateCustomers(dt);
 
@@ -135,102 +261,102 @@ void CafeScene::update(float dt) {
     updateQueuePenalty(dt);
   }
 
-  dialogue_.update(dt);
-  hud_.update(totalElapsed_, barista_.order(), inConversation_);
+  // HUD and dialogue animation only feed draw(), which headless runs skip.
+  if (context().window) {
+    dialogue_.update(dt);
+    hud_.update(totalElapsed_, barista_.order(), inConversation_);
+  }
 }
 
-void CafeScene::draw(sf::RenderTarget& target) {
-  target.draw(background_);
-
-  for (auto& customer : customers_) {
-    customer.draw(target);
-  }
+void CafeScene::draw(sf::RenderTarget& target, float alpha) {
+  // The background never changes after setupWorld(), so the labels'
+  // revision is the whole layer's.
+  backdropLayer_.draw(target, hud_.fixedLabelsRevision(), [this](sf::RenderTarget& backdrop) {
+    backdrop.draw(background_);
+    hud_.drawFixedLabels(backdrop);
+  });
 
-  barista_.draw(target);
-  player_.draw(target);
+  worldBatch_.clear();
+  batchWorld(worldBatch_, alpha);
+  target.draw(worldBatch_);
 
   hud_.draw(target);
   dialogue_.draw(target);
 }
 
-void CafeScene::setupWorld() {
+void CafeScene::capture(RenderSnapshot& snapshot) const {
+  snapshot.beginLayer(backdropLayer_.area(), hud_.fixedLabelsRevision());
+  snapshot.add(background_);
+  hud_.captureFixedLabels(snapshot);
+  snapshot.endLayer();
+
+  // Snapshots are taken right after a tick, so there is nothing to blend.
+  batchWorld(snapshot.addBatch(), 1.0f);
+
+  hud_.capture(snapshot);
+  dialogue_.capture(snapshot);
+}
+
+void CafeScene::batchWorld(SpriteBatch& batch, float alpha) const {
+  customers_.batch(batch, alpha);
+  batchSprites(world_, sprites_, batch, alpha);
+}
+
+sf::FloatRect CafeScene::bounds(EntityId entity) const {
+  return spriteBounds(world_, sprites_, entity);
+}
+
+void CafeScene::setupWorld(std::size_t customerCount) {
   auto& resources = context().resources;
 
-  const auto& bgTexture = resources.texture("cafe_bg");
-  background_.setTexture(bgTexture);
+  background_ = makeScaledSprite(resources, TextureId::CafeBackground, {1280.0f, 720.0f}, {0.0f, 0.0f});
   background_.setPosition(0.0f, 0.0f);
-  const auto bgSize = bgTexture.getSize();
-  if (bgSize.x > 0 && bgSize.y > 0) {
-    background_.setScale(1280.0f / static_cast<float>(bgSize.x),
-                         720.0f / static_cast<float>(bgSize.y));
-  }
-
-  sf::Sprite playerSprite(resources.texture("player"));
-  playerSprite.setOrigin(playerSprite.getLocalBounds().width / 2.0f,
-                         playerSprite.getLocalBounds().height / 2.0f);
-  const auto playerSize = playerSprite.getTexture()->getSize();
-  if (playerSize.x > 0 && playerSize.y > 0) {
-    playerSprite.setScale(72.0f / static_cast<float>(playerSize.x),
-                          120.0f / static_cast<float>(playerSize.y));
-  }
-  player_.setSprite(playerSprite);
-  player_.setPosition({360.0f, 540.0f});
-
-  sf::Sprite baristaSprite(resources.texture("barista"));
-  baristaSprite.setOrigin(baristaSprite.getLocalBounds().width / 2.0f,
-                          baristaSprite.getLocalBounds().height);
-  const auto baristaSize = baristaSprite.getTexture()->getSize();
-  if (baristaSize.x > 0 && baristaSize.y > 0) {
-    baristaSprite.setScale(80.0f / static_cast<float>(baristaSize.x),
-                           140.0f / static_cast<float>(baristaSize.y));
-  }
-  barista_.setSprite(baristaSprite);
-  barista_.setPosition({640.0f, 260.0f});
-
-  sf::Sprite customerSprite(resources.texture("customer"));
-  customerSprite.setOrigin(customerSprite.getLocalBounds().width / 2.0f,
-                           customerSprite.getLocalBounds().height);
-  const auto customerSize = customerSprite.getTexture()->getSize();
-  if (customerSize.x > 0 && customerSize.y > 0) {
-    customerSprite.setScale(70.0f / static_cast<float>(customerSize.x),
-                            110.0f / static_cast<float>(customerSize.y));
+  backdropLayer_.setArea({0.0f, 0.0f, 1280.0f, 720.0f});
+
+  world_.clear();
+  sprites_.clear();
+  sprites_.push_back(makeScaledSprite(resources, TextureId::Barista, {80.0f, 140.0f}, {0.5f, 1.0f}));
+  sprites_.push_back(makeScaledSprite(resources, TextureId::Player, kPlayerSize, {0.5f, 0.5f}));
+  const sf::Vector2f baristaPosition{640.0f, 260.0f};
+  baristaEntity_ = world_.create(Transform{baristaPosition, baristaPosition}, SpriteRef{0, {}},
+                                 IdleAnimation{4.0f, 2.0f, 0.0f});
+  player_.spawn(world_, 1, {360.0f, 540.0f});
+
+  colliderIndex_.clear();
+  const std::span<const sf::FloatRect> colliders = layout_->colliders();
+  for (std::size_t i = 0; i < colliders.size(); ++i) {
+    colliderIndex_.insert(static_cast<SpatialHash::Id>(i), colliders[i]);
   }
+  playerPaths_.setGrid(layout_->playerGrid());
 
   customers_.clear();
-  customerPaths_.clear();
-  const std::vector<sf::Vector2f> queueTargets = {
-      {720.0f, 420.0f},
-      {780.0f, 470.0f},
-      {840.0f, 520.0f},
-  };
-
-  for (std::size_t i = 0; i < queueTargets.size(); ++i) {
-    Customer customer;
-    customer.setSprite(customerSprite);
-    std::vector<sf::Vector2f> path = {
-        {1100.0f + static_cast<float>(i) * 40.0f, 710.0f},
-        queueTargets[i]};
-    customer.setPath(path);
-    customers_.push_back(customer);
-    customerPaths_.push_back(path);
+  customers_.reserve(customerCount);
+  customers_.seed(random_.split());
+  customers_.setAppearance(
+      makeScaledSprite(resources, TextureId::Customer, {70.0f, 110.0f}, {0.5f, 1.0f}));
+  for (std::size_t i = 0; i < customerCount; ++i) {
+    // Counter customers share one flow field to the counter, then step into
+    // their own slot; the others start off the floor and walk straight in.
+    const std::array<sf::Vector2f, 2> route = customerDoorAndSlot(i);
+    customers_.add(route, i < kCounterSlots.size() ? &layout_->counterFlow() : nullptr);
   }
 
-  colliders_.clear();
-  colliders_.push_back({0.0f, 180.0f, 1280.0f, 160.0f});   // Counter row
-  colliders_.push_back({120.0f, 360.0f, 240.0f, 120.0f});  // Tables
-  colliders_.push_back({420.0f, 380.0f, 160.0f, 120.0f});
-  colliders_.push_back({980.0f, 360.0f, 200.0f, 140.0f});
+  interactableIndex_.clear();
+  interactableIndex_.insert(kBaristaInteractable, bounds(baristaEntity_));
+  // Roughly two buckets per customer keeps crowded buckets short.
+  customerIndex_ = SpatialHash(64.0f, std::max<std::size_t>(256, customerCount * 2));
+  rebuildCustomerIndex();
 }
 
 void CafeScene::beginConversation() {
-  context().audio.playSound("ui_click", 50.0f);
+  context().audio.playSound(SoundId::UiClick, 50.0f);
   barista_.startConversation();
   inConversation_ = true;
   nameBuffer_.clear();
   idleTimer_ = 0.0f;
   penaltyTriggered_ = false;
   penaltyTime_ = 0.0f;
-  orderClock_.restart();
+  conversationStartTime_ = totalElapsed_;
   distanceAtConversationStart_ = player_.distanceTraveled();
   stepsAtConversationStart_ = player_.stepCount();
   hud_.clearHint();
@@ -248,7 +374,7 @@ void CafeScene::handleOptionSelection(std::size_t index) {
   if (index >= barista_.options().size()) {
     return;
   }
-  context().audio.playSound("ui_click", 45.0f);
+  context().audio.playSound(SoundId::UiClick, 45.0f);
   barista_.selectOption(index);
   idleTimer_ = 0.0f;
   penaltyTriggered_ = false;
@@ -262,7 +388,7 @@ void CafeScene::handleOptionSelection(std::size_t index) {
 
 void CafeScene::submitName() {
   barista_.submitName(nameBuffer_);
-  context().audio.playSound("ui_click", 45.0f);
+  context().audio.playSound(SoundId::UiClick, 45.0f);
   idleTimer_ = 0.0f;
   penaltyTriggered_ = false;
   hud_.clearHint();
@@ -273,43 +399,128 @@ void CafeScene::submitName() {
 }
 
 void CafeScene::finalizeOrder() {
-  const auto validation = validateOrder(barista_.order());
+  const OrderFieldMask required = barista_.dialogue().requiredFields();
+  const OrderFieldMask missing = validateOrder(barista_.order(), required);
   OrderReport report;
-  report.complete = validation.complete;
-  report.missingFields = validation.missing;
-  report.timeSeconds = orderClock_.getElapsedTime().asSeconds() + penaltyTime_;
+  report.complete = missing == 0;
+  report.missingFields = missing;
+  report.order = barista_.order();
+  report.requiredFields = required;
+  report.timeSeconds = (totalElapsed_ - conversationStartTime_) + penaltyTime_;
+  report.penaltySeconds = penaltyTime_;
   report.pathDistance = std::max(0.0f, player_.distanceTraveled() - distanceAtConversationStart_);
   report.steps = player_.stepCount() - stepsAtConversationStart_;
-  report.tip = validation.complete ? "Consider approaching from the left aisle for a shorter path."
-                                   : "Make sure to fill in every field before confirming.";
+  const auto notes = barista_.dialogue().coachingNotes();
+  if (!report.complete) {
+    report.tip = "Make sure to fill in every field before confirming.";
+  } else if (!notes.empty()) {
+    report.tip = barista_.dialogue().text(notes.front());
+  } else {
+    report.tip = "Consider approaching from the left aisle for a shorter path.";
+  }
 
   inConversation_ = false;
   dialogue_.setVisible(false);
   hud_.clearHint();
 
-  app().showReport(report);
+  host().showReport(report);
 }
 
 void CafeScene::updateCustomers(float dt) {
-  for (std::size_t i = 0; i < customers_.size(); ++i) {
-    customers_[i].update(dt);
+  // A settled queue keeps last tick's index, which is still exact.
+  if (customers_.update(dt, context().jobs)) {
+    rebuildCustomerIndex();
+    separateCustomers();
   }
 }
 
 void CafeScene::updateCollisions(const sf::Vector2f& previousPos) {
-  for (const auto& collider : colliders_) {
-    if (player_.bounds().intersects(collider)) {
-      player_.revertPosition(previousPos);
-      break;
+  queryScratch_.clear();
+  colliderIndex_.queryRect(bounds(player_.entity()), queryScratch_);
+  if (!queryScratch_.empty()) {
+    player_.revertPosition(previousPos);
+  }
+}
+
+void CafeScene::separateCustomers() {
+  // Customers closer than this (feet to feet) push each other apart, half
+  // the overlap each, so a crowd spreads out instead of stacking up.
+  constexpr float kMinSeparation = 36.0f;
+
+  for (std::size_t i = 0; i < customers_.size(); ++i) {
+    queryScratch_.clear();
+    customerIndex_.queryRadius(customers_.position(i), kMinSeparation, queryScratch_);
+
+    for (const SpatialHash::Id neighbour : queryScratch_) {
+      if (neighbour <= i) {
+        continue;  // each pair once
+      }
+      const sf::Vector2f delta = customers_.position(neighbour) - customers_.position(i);
+      const float distance = utils::length(delta);
+      if (distance >= kMinSeparation || distance <= 0.0001f) {
+        continue;
+      }
+      const sf::Vector2f push = delta * ((kMinSeparation - distance) * 0.5f / distance);
+      customers_.move(i, -push);
+      customers_.move(neighbour, push);
+    }
+  }
+}
+
+void CafeScene::rebuildCustomerIndex() {
+  customerIndex_.clear();
+  for (std::size_t i = 0; i < customers_.size(); ++i) {
+    // Customers are indexed as points at their feet, the position
+    // separation works with.
+    const sf::Vector2f feet = customers_.position(i);
+    customerIndex_.insert(static_cast<SpatialHash::Id>(i), sf::FloatRect(feet, {0.0f, 0.0f}));
+  }
+}
+
+bool CafeScene::baristaInReach() {
+  const float radius = player_.interactionRadius();
+  sf::FloatRect reach = bounds(player_.entity());
+  reach.left -= radius;
+  reach.top -= radius;
+  reach.width += radius * 2.0f;
+  reach.height += radius * 2.0f;
+
+  queryScratch_.clear();
+  interactableIndex_.queryRect(reach, queryScratch_);
+  for (const SpatialHash::Id interactable : queryScratch_) {
+    if (interactable == kBaristaInteractable &&
+        boundsGap(bounds(player_.entity()), bounds(baristaEntity_)) <= radius) {
+      return true;
     }
   }
+  return false;
+}
+
+void CafeScene::walkToBarista() {
+  // The barista stands behind the counter, so the route ends on the closest
+  // walkable spot, right in front of them.
+  if (playerPaths_.findPath(player_.position(), world_.get<Transform>(baristaEntity_)->position,
+                            pathScratch_)) {
+    player_.walkPath(pathScratch_);
+    walkingToBarista_ = true;
+  }
+}
+
+void CafeScene::updateWalkToBarista() {
+  if (!walkingToBarista_ || player_.isAutoWalking()) {
+    return;
+  }
+  walkingToBarista_ = false;
+  if (player_.reachedWalkTarget() && !inConversation_ && baristaInReach()) {
+    beginConversation();
+  }
 }
 
 void CafeScene::updateQueuePenalty(float dt) {
   if (!penaltyTriggered_ && idleTimer_ > 6.0f && !customers_.empty()) {
     penaltyTriggered_ = true;
     penaltyTime_ += 3.0f;
-    context().audio.playSound("ui_click", 30.0f);
+    context().audio.playSound(SoundId::UiClick, 30.0f);
     hud_.setHint("Take your time! Queue is waiting...");
   }
 }
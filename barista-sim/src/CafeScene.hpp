@@ -1,32 +1,78 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
-#include <SFML/System/Clock.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "Barista.hpp"
-#include "Customer.hpp"
+#include "Crowd.hpp"
+#include "DialogueGraph.hpp"
 #include "DialogueUI.hpp"
+#include "Ecs.hpp"
 #include "HUD.hpp"
+#include "Pathfinding.hpp"
 #include "Player.hpp"
+#include "Random.hpp"
 #include "Scene.hpp"
-#include "Timer.hpp"
+#include "SpatialHash.hpp"
+#include "SpriteBatch.hpp"
+#include "StaticLayer.hpp"
+
+class JobSystem;
+class ResourceManager;
+
+// The café's fixed geometry: collider boxes and the navigation grids and
+// counter flow field baked from them. Nothing changes after build(), so one
+// layout can back any number of scenes, on any threads, at once.
+class CafeLayout {
+ public:
+  // Bakes on jobs; resources give the player's size. Scenes built from the
+  // same resources can share the result.
+  [[nodiscard]] static std::shared_ptr<const CafeLayout> build(const ResourceManager& resources,
+                                                               JobSystem& jobs);
+
+  CafeLayout(const CafeLayout&) = delete;
+  CafeLayout& operator=(const CafeLayout&) = delete;
+
+  [[nodiscard]] std::span<const sf::FloatRect> colliders() const;
+  [[nodiscard]] const NavGrid& playerGrid() const;
+  [[nodiscard]] const NavGrid& customerGrid() const;
+  // Points into customerGrid(), hence no copies.
+  [[nodiscard]] const FlowField& counterFlow() const;
+
+ private:
+  CafeLayout() = default;
+
+  std::vector<sf::FloatRect> colliders_;
+  NavGrid playerGrid_;
+  NavGrid customerGrid_;
+  FlowField counterFlow_;
+};
 
 class CafeScene : public Scene {
  public:
-  CafeScene(App& app, SceneContext context);
+  // dialogue is the scenario the barista runs; it must outlive the scene.
+  // Every random number the scene draws comes from seed, so a session with
+  // the same seed and input plays out the same. layout must have been built
+  // from context's resources; null bakes one for this scene alone.
+  CafeScene(SceneHost& host, SceneContext context, const DialogueGraph& dialogue,
+            std::size_t customerCount, std::uint64_t seed,
+            std::shared_ptr<const CafeLayout> layout);
 
   void onEnter() override;
   void onExit() override;
 
   void handleEvent(const sf::Event& event) override;
   void update(float dt) override;
-  void draw(sf::RenderTarget& target) override;
+  void draw(sf::RenderTarget& target, float alpha) override;
+  void capture(RenderSnapshot& snapshot) const override;
 
  private:
-  void setupWorld();
+  void setupWorld(std::size_t customerCount);
   void beginConversation();
   void refreshDialogue();
   void handleOptionSelection(std::size_t index);
@@ -34,15 +80,46 @@ class CafeScene : public Scene {
   void finalizeOrder();
   void updateCustomers(float dt);
   void updateCollisions(const sf::Vector2f& previousPos);
+  void separateCustomers();
+  void rebuildCustomerIndex();
+  [[nodiscard]] bool baristaInReach();
+  void walkToBarista();
+  void updateWalkToBarista();
   void updateQueuePenalty(float dt);
+  void batchWorld(SpriteBatch& batch, float alpha) const;
+  [[nodiscard]] sf::FloatRect bounds(EntityId entity) const;
 
   sf::Sprite background_;
+  // The background plus the HUD's fixed labels, composited once and drawn
+  // as one quad under the world.
+  StaticLayer backdropLayer_;
+  // The player and barista are World entities drawing from sprites_;
+  // customers stay in the Crowd, which is already stored column by column.
+  World world_;
+  std::vector<sf::Sprite> sprites_;
+  EntityId baristaEntity_;
   Player player_;
   Barista barista_;
-  std::vector<Customer> customers_;
-  std::vector<std::vector<sf::Vector2f>> customerPaths_;
+  Crowd customers_;
+  Random random_;
 
-  std::vector<sf::FloatRect> colliders_;
+  std::shared_ptr<const CafeLayout> layout_;
+
+  // Broadphase: colliders and interactables don't move and are indexed once
+  // in setupWorld(); customers (id = index) are re-indexed on ticks where
+  // any of them moved.
+  static constexpr SpatialHash::Id kBaristaInteractable = 0;
+  SpatialHash colliderIndex_{128.0f, 256};
+  SpatialHash interactableIndex_{128.0f, 64};
+  SpatialHash customerIndex_{64.0f, 256};
+  std::vector<SpatialHash::Id> queryScratch_;
+
+  // Routes over the layout's player grid, with this scene's own cache.
+  Pathfinder playerPaths_;
+  std::vector<sf::Vector2f> pathScratch_;
+  bool walkingToBarista_{false};
+
+  SpriteBatch worldBatch_;
 
   DialogueUI dialogue_;
   HUD hud_;
@@ -52,7 +129,7 @@ class CafeScene : public Scene {
   float idleTimer_{0.0f};
   bool penaltyTriggered_{false};
 
-  sf::Clock orderClock_;
+  float conversationStartTime_{0.0f};
   float penaltyTime_{0.0f};
   float distanceAtConversationStart_{0.0f};
   unsigned stepsAtConversationStart_{0};
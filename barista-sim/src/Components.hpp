@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+
+// Components for World entities. Each is plain data so the World can pack
+// them into chunks; systems in Systems.hpp work on them.
+
+// Where the entity stands this tick and where it stood at the start of it,
+// for interpolated rendering.
+struct Transform {
+  sf::Vector2f position;
+  sf::Vector2f previous;
+};
+
+struct Velocity {
+  sf::Vector2f value;
+};
+
+// Index into the scene's sprite table. The table's sprites sit at the origin
+// and carry texture, origin and scale; the entity's Transform places them,
+// shifted by drawOffset, which only affects drawing.
+struct SpriteRef {
+  std::uint32_t sprite;
+  sf::Vector2f drawOffset;
+};
+
+// Walks nodes[cursor..count) at speed. nodes is owned elsewhere and must
+// outlive the walk; the walk is over once cursor reaches count.
+struct PathMotion {
+  const sf::Vector2f* nodes;
+  std::uint32_t count;
+  std::uint32_t cursor;
+  float speed;
+};
+
+// Bobs the sprite up and down through SpriteRef::drawOffset; the Transform
+// stays put, so bounds and collisions ignore it.
+struct IdleAnimation {
+  float amplitude;
+  float speed;
+  float phase;
+};
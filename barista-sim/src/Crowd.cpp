@@ -0,0 +1,287 @@
+#include "Crowd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "JobSystem.hpp"
+#include "Pathfinding.hpp"
+#include "SpriteBatch.hpp"
+
+namespace {
+constexpr float kArriveDistance = 4.0f;
+
+// Kernels: plain loops over arrays that touch each element once, without
+// branches, so the compiler vectorizes them for whatever SIMD width the
+// target allows (SSE2 on baseline x86-64, AVX with -mavx2). __restrict keeps
+// GCC from giving up on the alias checks between this many arrays, and
+// -fno-math-errno (see CMakeLists.txt) lets it use vector square roots.
+
+// Points each velocity at the member's path target at full speed and flags
+// members already within kArriveDistance of it; the caller stops those.
+void steer(std::size_t count, const float* __restrict x, const float* __restrict y,
+           const float* __restrict targetX, const float* __restrict targetY,
+           const float* __restrict speed, float* __restrict velocityX,
+           float* __restrict velocityY, std::uint8_t* __restrict arrived) {
+  constexpr float kArriveSquared = kArriveDistance * kArriveDistance;
+  // Keeps the division finite for a member standing exactly on its target.
+  constexpr float kEpsilon = 1e-6f;
+  for (std::size_t i = 0; i < count; ++i) {
+    const float dx = targetX[i] - x[i];
+    const float dy = targetY[i] - y[i];
+    const float distanceSquared = dx * dx + dy * dy;
+    const float scale = speed[i] / std::sqrt(distanceSquared + kEpsilon);
+    velocityX[i] = dx * scale;
+    velocityY[i] = dy * scale;
+    arrived[i] = distanceSquared < kArriveSquared ? 1 : 0;
+  }
+}
+
+void integrate(std::size_t count, float dt, const float* __restrict velocity,
+               float* __restrict position) {
+  for (std::size_t i = 0; i < count; ++i) {
+    position[i] += velocity[i] * dt;
+  }
+}
+
+void interpolate(std::size_t count, float alpha, const float* __restrict previous,
+                 const float* __restrict current, float* __restrict out) {
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = previous[i] + (current[i] - previous[i]) * alpha;
+  }
+}
+}  // namespace
+
+void Crowd::clear() {
+  for (auto* field : {&x_, &y_, &previousX_, &previousY_, &velocityX_, &velocityY_, &targetX_,
+                      &targetY_, &speed_, &shuffleTimer_, &drawX_, &drawY_, &depths_}) {
+    field->clear();
+  }
+  random_.clear();
+  arrived_.clear();
+  pathCursor_.clear();
+  pathEnd_.clear();
+  pathNodes_.clear();
+  flow_.clear();
+  flowFields_.clear();
+  vertices_.clear();
+  walking_ = 0;
+  flowing_ = 0;
+}
+
+void Crowd::reserve(std::size_t count) {
+  for (auto* field : {&x_, &y_, &previousX_, &previousY_, &velocityX_, &velocityY_, &targetX_,
+                      &targetY_, &speed_, &shuffleTimer_}) {
+    field->reserve(count);
+  }
+  random_.reserve(count);
+  arrived_.reserve(count);
+  pathCursor_.reserve(count);
+  pathEnd_.reserve(count);
+  flow_.reserve(count);
+  vertices_.reserve(count * 4);
+}
+
+void Crowd::seed(const Random& source) {
+  source_ = source;
+}
+
+void Crowd::setAppearance(const sf::Sprite& sprite) {
+  sf::Sprite local(sprite);
+  local.setPosition(0.0f, 0.0f);
+
+  const sf::IntRect rect = local.getTextureRect();
+  const auto width = static_cast<float>(std::abs(rect.width));
+  const auto height = static_cast<float>(std::abs(rect.height));
+  const auto left = static_cast<float>(rect.left);
+  const auto top = static_cast<float>(rect.top);
+  const auto right = static_cast<float>(rect.left + rect.width);
+  const auto bottom = static_cast<float>(rect.top + rect.height);
+
+  const sf::Transform& transform = local.getTransform();
+  const sf::Color color = local.getColor();
+  corners_[0] = sf::Vertex(transform.transformPoint(0.0f, 0.0f), color, {left, top});
+  corners_[1] = sf::Vertex(transform.transformPoint(width, 0.0f), color, {right, top});
+  corners_[2] = sf::Vertex(transform.transformPoint(0.0f, height), color, {left, bottom});
+  corners_[3] = sf::Vertex(transform.transformPoint(width, height), color, {right, bottom});
+
+  const sf::FloatRect bounds = local.getGlobalBounds();
+  depthOffset_ = bounds.top + bounds.height;
+  texture_ = local.getTexture();
+
+  for (std::size_t i = 0; i < vertices_.size(); ++i) {
+    vertices_[i].color = corners_[i % 4].color;
+    vertices_[i].texCoords = corners_[i % 4].texCoords;
+  }
+}
+
+std::size_t Crowd::add(std::span<const sf::Vector2f> path, const FlowField* flow, float speed) {
+  const std::size_t index = x_.size();
+  const sf::Vector2f start = path.empty() ? sf::Vector2f{} : path.front();
+  const auto first = static_cast<std::uint32_t>(pathNodes_.size());
+  pathNodes_.insert(pathNodes_.end(), path.begin(), path.end());
+  const auto end = static_cast<std::uint32_t>(pathNodes_.size());
+
+  x_.push_back(start.x);
+  y_.push_back(start.y);
+  previousX_.push_back(start.x);
+  previousY_.push_back(start.y);
+  velocityX_.push_back(0.0f);
+  velocityY_.push_back(0.0f);
+  targetX_.push_back(start.x);
+  targetY_.push_back(start.y);
+  speed_.push_back(path.empty() ? 0.0f : speed);
+  shuffleTimer_.push_back(0.0f);
+  random_.push_back(source_.stream(index));
+  arrived_.push_back(0);
+  pathCursor_.push_back(first);
+  pathEnd_.push_back(end);
+  vertices_.insert(vertices_.end(), corners_.begin(), corners_.end());
+
+  std::uint16_t field = kNoFlow;
+  if (flow != nullptr && first != end) {
+    const auto known = std::find(flowFields_.begin(), flowFields_.end(), flow);
+    field = static_cast<std::uint16_t>(known - flowFields_.begin());
+    if (known == flowFields_.end()) {
+      flowFields_.push_back(flow);
+    }
+    ++flowing_;
+  }
+  flow_.push_back(field);
+
+  if (first != end) {
+    ++walking_;
+  }
+  return index;
+}
+
+void Crowd::beginTick() {
+  std::copy(x_.begin(), x_.end(), previousX_.begin());
+  std::copy(y_.begin(), y_.end(), previousY_.begin());
+}
+
+bool Crowd::update(float dt, JobSystem& jobs) {
+  const bool walked = walking_ > 0;
+  std::size_t fidgeted = 0;
+  tallies_.assign((size() + kChunkSize - 1) / kChunkSize, Tally{});
+  jobs.parallelFor(size(), kChunkSize, [this, dt](std::size_t begin, std::size_t end) {
+    updateRange(begin, end, dt, tallies_[begin / kChunkSize]);
+  });
+  for (const Tally& tally : tallies_) {
+    flowing_ -= tally.leftFlow;
+    walking_ -= tally.finished;
+    fidgeted += tally.fidgeted;
+  }
+  return walked || fidgeted > 0;
+}
+
+std::size_t Crowd::size() const {
+  return x_.size();
+}
+
+bool Crowd::empty() const {
+  return x_.empty();
+}
+
+sf::Vector2f Crowd::position(std::size_t index) const {
+  return {x_[index], y_[index]};
+}
+
+void Crowd::move(std::size_t index, const sf::Vector2f& offset) {
+  x_[index] += offset.x;
+  y_[index] += offset.y;
+}
+
+void Crowd::batch(SpriteBatch& batch, float alpha) const {
+  const std::size_t count = size();
+  drawX_.resize(count);
+  drawY_.resize(count);
+  depths_.resize(count);
+  interpolate(count, alpha, previousX_.data(), x_.data(), drawX_.data());
+  interpolate(count, alpha, previousY_.data(), y_.data(), drawY_.data());
+
+  for (std::size_t i = 0; i < count; ++i) {
+    sf::Vertex* quad = &vertices_[i * 4];
+    for (std::size_t corner = 0; corner < 4; ++corner) {
+      quad[corner].position.x = drawX_[i] + corners_[corner].position.x;
+      quad[corner].position.y = drawY_[i] + corners_[corner].position.y;
+    }
+    depths_[i] = drawY_[i] + depthOffset_;
+  }
+
+  batch.addQuads(texture_, vertices_.data(), depths_.data(), count);
+}
+
+void Crowd::updateRange(std::size_t begin, std::size_t end, float dt, Tally& tally) {
+  const std::size_t count = end - begin;
+  steer(count, x_.data() + begin, y_.data() + begin, targetX_.data() + begin,
+        targetY_.data() + begin, speed_.data() + begin, velocityX_.data() + begin,
+        velocityY_.data() + begin, arrived_.data() + begin);
+  // Arrivals are decided on this tick's start positions: a member reaching a
+  // node stands still for the tick and heads for the next one after that.
+  followFlows(begin, end, tally);
+  advancePaths(begin, end, tally);
+  integrate(count, dt, velocityX_.data() + begin, x_.data() + begin);
+  integrate(count, dt, velocityY_.data() + begin, y_.data() + begin);
+  fidget(begin, end, dt, tally);
+}
+
+void Crowd::followFlows(std::size_t begin, std::size_t end, Tally& tally) {
+  if (flowing_ == 0) {
+    return;
+  }
+  for (std::size_t i = begin; i < end; ++i) {
+    // Members arriving at a node stop for the tick whatever the field says.
+    if (flow_[i] == kNoFlow || arrived_[i]) {
+      continue;
+    }
+    const sf::Vector2f direction = flowFields_[flow_[i]]->direction({x_[i], y_[i]});
+    if (direction.x == 0.0f && direction.y == 0.0f) {
+      flow_[i] = kNoFlow;
+      ++tally.leftFlow;
+      continue;
+    }
+    velocityX_[i] = direction.x * speed_[i];
+    velocityY_[i] = direction.y * speed_[i];
+  }
+}
+
+void Crowd::advancePaths(std::size_t begin, std::size_t end, Tally& tally) {
+  for (std::size_t i = begin; i < end; ++i) {
+    if (!arrived_[i] || pathCursor_[i] == pathEnd_[i]) {
+      continue;
+    }
+    velocityX_[i] = 0.0f;
+    velocityY_[i] = 0.0f;
+    if (++pathCursor_[i] == pathEnd_[i]) {
+      // Done walking: a zero speed keeps it in place wherever separation or
+      // fidgeting pushes it.
+      speed_[i] = 0.0f;
+      ++tally.finished;
+      if (flow_[i] != kNoFlow) {
+        flow_[i] = kNoFlow;
+        ++tally.leftFlow;
+      }
+      continue;
+    }
+    const sf::Vector2f node = pathNodes_[pathCursor_[i]];
+    targetX_[i] = node.x;
+    targetY_[i] = node.y;
+  }
+}
+
+void Crowd::fidget(std::size_t begin, std::size_t end, float dt, Tally& tally) {
+  for (std::size_t i = begin; i < end; ++i) {
+    shuffleTimer_[i] -= dt;
+    if (shuffleTimer_[i] > 0.0f) {
+      continue;
+    }
+    // The next wait (2-4 s) and a small nudge, in one draw.
+    std::array<float, 3> draw;
+    random_[i].fill(draw);
+    shuffleTimer_[i] = 2.0f + 2.0f * draw[0];
+    x_[i] += 4.0f * draw[1] - 2.0f;
+    y_[i] += 2.0f * draw[2] - 1.0f;
+    ++tally.fidgeted;
+  }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Random.hpp"
+
+class FlowField;
+class JobSystem;
+class SpriteBatch;
+
+// Queueing customers stored as structure-of-arrays: every per-member field
+// lives in its own contiguous array, so the tick is a handful of plain loops
+// over floats (see the kernels in Crowd.cpp) that the compiler vectorizes,
+// and rendering writes all members into one vertex buffer sharing a single
+// texture. Members walk their path at a fixed speed, stop at its last node
+// and fidget every few seconds, drawing from their own random stream. A
+// member given a flow field follows it towards the field's goals first, then
+// walks the rest of its path.
+class Crowd {
+ public:
+  static constexpr float kDefaultSpeed = 80.0f;
+  // Members per job when the tick is split across threads.
+  static constexpr std::size_t kChunkSize = 1024;
+
+  void clear();
+  void reserve(std::size_t count);
+
+  // Members added from now on take their random streams from source.
+  void seed(const Random& source);
+
+  // Texture, texture rect, origin, scale and color shared by every member;
+  // the sprite's own position is ignored.
+  void setAppearance(const sf::Sprite& sprite);
+
+  // Adds a member standing on path.front() and returns its index. With a
+  // flow field, the member steers down it from the second node on, until it
+  // reaches a goal cell or leaves the field, and then heads straight for its
+  // current node. The field must outlive the member.
+  std::size_t add(std::span<const sf::Vector2f> path, const FlowField* flow = nullptr,
+                  float speed = kDefaultSpeed);
+
+  // Call once at the start of every fixed tick, before anything moves.
+  void beginTick();
+  // Returns true when any member may have moved this tick. Steering and
+  // movement run in chunks of kChunkSize members on jobs; members never
+  // read each other or share random numbers, so the result does not depend
+  // on the thread count.
+  bool update(float dt, JobSystem& jobs);
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] bool empty() const;
+  [[nodiscard]] sf::Vector2f position(std::size_t index) const;
+  // Nudges a member without interrupting its path (used by separation).
+  void move(std::size_t index, const sf::Vector2f& offset);
+
+  // Queues every member at its interpolated position, depth-sorted by feet.
+  void batch(SpriteBatch& batch, float alpha) const;
+
+ private:
+  // Members leaving their flow field or finishing their path in one chunk.
+  struct Tally {
+    std::size_t leftFlow{0};
+    std::size_t finished{0};
+    std::size_t fidgeted{0};
+  };
+
+  // Steers, advances and moves members [begin, end).
+  void updateRange(std::size_t begin, std::size_t end, float dt, Tally& tally);
+  // Overrides the steering of members still on a flow field.
+  void followFlows(std::size_t begin, std::size_t end, Tally& tally);
+  void advancePaths(std::size_t begin, std::size_t end, Tally& tally);
+  void fidget(std::size_t begin, std::size_t end, float dt, Tally& tally);
+
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<float> previousX_;
+  std::vector<float> previousY_;
+  std::vector<float> velocityX_;
+  std::vector<float> velocityY_;
+  std::vector<float> targetX_;
+  std::vector<float> targetY_;
+  std::vector<float> speed_;
+  std::vector<float> shuffleTimer_;
+  std::vector<Random> random_;
+  std::vector<std::uint8_t> arrived_;
+  // Path cursors index pathNodes_; a member is done once cursor == end.
+  std::vector<std::uint32_t> pathCursor_;
+  std::vector<std::uint32_t> pathEnd_;
+  std::vector<sf::Vector2f> pathNodes_;
+  std::size_t walking_{0};
+  // Index into flowFields_ per member, kNoFlow once off (or never on) one.
+  static constexpr std::uint16_t kNoFlow = 0xffff;
+  std::vector<std::uint16_t> flow_;
+  std::vector<const FlowField*> flowFields_;
+  std::size_t flowing_{0};
+  std::vector<Tally> tallies_;
+  Random source_;
+
+  const sf::Texture* texture_{nullptr};
+  // Quad corners (top-left, top-right, bottom-left, bottom-right) with
+  // positions relative to a member's position, and the depth of its feet.
+  std::array<sf::Vertex, 4> corners_{};
+  float depthOffset_{0.0f};
+
+  // Render buffers, 4 vertices per member. Colors and texture coordinates
+  // are written when members are added; batch() only rewrites positions.
+  mutable std::vector<float> drawX_;
+  mutable std::vector<float> drawY_;
+  mutable std::vector<float> depths_;
+  mutable std::vector<sf::Vertex> vertices_;
+};
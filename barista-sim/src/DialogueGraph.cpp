@@ -0,0 +1,346 @@
+#include "DialogueGraph.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+constexpr char kCacheMagic[4] = {'B', 'S', 'D', 'G'};
+constexpr std::uint32_t kCacheVersion = 3;
+
+constexpr std::string_view kBuiltinScenario = R"({
+  "title": "Morning order",
+  "menu": {
+    "drinks": ["Latte", "Americano", "Cappuccino", "Mocha"],
+    "sizes": ["Small", "Medium", "Large"],
+    "milks": ["Whole Milk", "Oat Milk", "Almond Milk", "No Milk"]
+  },
+  "script": [
+    {"role": "barista", "line": "Welcome! What can I get started for you?", "ask": "drink"},
+    {"role": "barista", "line": "Great choice! What size would you like?", "ask": "size"},
+    {"role": "barista", "line": "Any milk preference today?", "ask": "milk"},
+    {"role": "barista", "line": "Perfect. Name for the order?", "ask": "name"},
+    {"role": "barista", "line": "Awesome! A {size} {drink} with {milk} for {name}."},
+    {"role": "user", "line": "Sounds great!"},
+    {"role": "barista", "line": "Your order is on its way! Feel free to take a seat."},
+    {"role": "user", "line": "Thanks!"}
+  ]
+})";
+
+template <typename T>
+bool readArray(std::istream& in, std::vector<T>& values, std::size_t count) {
+  values.resize(count);
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const std::vector<T>& values) {
+  out.write(reinterpret_cast<const char*>(values.data()),
+            static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+}  // namespace
+
+// Interns strings while a scenario compiles. The keys view the scenario's
+// JSON text, which outlives the builder.
+class DialogueGraph::Builder {
+ public:
+  Builder(DialogueGraph& graph, std::string_view sourceName)
+      : graph_(graph), sourceName_(sourceName) {
+    graph_.stringOffsets_.push_back(0);
+    intern({});
+  }
+
+  StringId intern(std::string_view text) {
+    const auto [found, inserted] =
+        ids_.try_emplace(text, static_cast<StringId>(graph_.stringOffsets_.size() - 1));
+    if (inserted) {
+      graph_.strings_.append(text);
+      graph_.stringOffsets_.push_back(static_cast<std::uint32_t>(graph_.strings_.size()));
+    }
+    return found->second;
+  }
+
+  [[noreturn]] void fail(const std::string& message) const {
+    throw std::runtime_error(std::string(sourceName_) + ": " + message);
+  }
+
+ private:
+  DialogueGraph& graph_;
+  std::string_view sourceName_;
+  std::unordered_map<std::string_view, StringId> ids_;
+};
+
+const DialogueGraph& DialogueGraph::builtin() {
+  static const DialogueGraph graph =
+      compile(JsonDocument::parse(kBuiltinScenario, "<builtin>").root(), "<builtin>");
+  return graph;
+}
+
+DialogueGraph DialogueGraph::compile(const JsonDocument::Value& scenario,
+                                     std::string_view sourceName) {
+  DialogueGraph graph;
+  Builder builder(graph, sourceName);
+  if (!scenario.isObject()) {
+    builder.fail("a scenario is a JSON object");
+  }
+  graph.title_ = builder.intern(scenario["title"].asString());
+  graph.setting_ = builder.intern(scenario["setting"].asString());
+  for (const JsonDocument::Value note : scenario["coachingNotes"]) {
+    graph.notes_.push_back(builder.intern(note.asString()));
+  }
+
+  const JsonDocument::Value menu = scenario["menu"];
+  const JsonDocument::Value script = scenario["script"];
+  if (script.size() == 0) {
+    builder.fail("the script is empty");
+  }
+
+  NodeId lastQuestion = kNoNode;
+  std::size_t lineNumber = 0;
+  for (const JsonDocument::Value line : script) {
+    ++lineNumber;
+    const std::string_view role = line["role"].asString();
+    if (!line["line"].isString()) {
+      builder.fail("script line " + std::to_string(lineNumber) + " has no text");
+    }
+    const StringId text = builder.intern(line["line"].asString());
+    const auto current = static_cast<NodeId>(graph.nodes_.size());
+
+    if (role == "user") {
+      if (graph.nodes_.empty()) {
+        builder.fail("the script must open with the barista");
+      }
+      Node& asking = graph.nodes_.back();
+      // Answers to questions come from the menu or the keyboard; the sample
+      // reply in the script is only for the web client.
+      if (asking.slot == Slot::None) {
+        graph.options_.push_back({text, current});
+        ++asking.optionCount;
+      }
+      continue;
+    }
+    if (role != "barista") {
+      builder.fail("unknown role '" + std::string(role) + "'");
+    }
+
+    // A line the player had no reply to gets one to move on with.
+    if (!graph.nodes_.empty() && graph.nodes_.back().slot == Slot::None &&
+        graph.nodes_.back().optionCount == 0) {
+      graph.options_.push_back({builder.intern("Continue"), current});
+      ++graph.nodes_.back().optionCount;
+    }
+
+    Node node{text, Slot::None, static_cast<std::uint32_t>(graph.options_.size()), 0, current + 1};
+    const std::string_view ask = line["ask"].asString();
+    std::string_view list;
+    if (ask == "drink") {
+      node.slot = Slot::Drink;
+      list = "drinks";
+    } else if (ask == "size") {
+      node.slot = Slot::Size;
+      list = "sizes";
+    } else if (ask == "milk") {
+      node.slot = Slot::Milk;
+      list = "milks";
+    } else if (ask == "name") {
+      node.slot = Slot::Name;
+    } else if (!ask.empty()) {
+      builder.fail("unknown question '" + std::string(ask) + "'");
+    }
+    if (!list.empty()) {
+      if (menu[list].size() == 0) {
+        builder.fail("asks for a " + std::string(ask) + " but menu." + std::string(list) +
+                     " is empty");
+      }
+      for (const JsonDocument::Value item : menu[list]) {
+        graph.options_.push_back({builder.intern(item.asString()), current + 1});
+        ++node.optionCount;
+      }
+    }
+    if (node.slot != Slot::None) {
+      lastQuestion = current;
+      graph.requiredFields_ |= orderFieldBit(field(node.slot));
+    }
+    if (!list.empty() && graph.menuNodes_[static_cast<std::size_t>(node.slot) - 1] == kNoNode) {
+      graph.menuNodes_[static_cast<std::size_t>(node.slot) - 1] = current;
+    }
+    graph.nodes_.push_back(node);
+  }
+
+  for (const Node& node : graph.nodes_) {
+    if (node.optionCount > kMaxOptions) {
+      builder.fail("a line offers more than " + std::to_string(kMaxOptions) + " options");
+    }
+  }
+  // Reaching the last node ends the conversation, so nothing leads on.
+  Node& last = graph.nodes_.back();
+  if (last.slot != Slot::None) {
+    builder.fail("the script cannot end on a question");
+  }
+  last.next = kNoNode;
+  for (std::uint32_t i = 0; i < last.optionCount; ++i) {
+    graph.options_[last.firstOption + i].next = kNoNode;
+  }
+  graph.closing_ = lastQuestion != kNoNode ? lastQuestion + 1
+                                           : static_cast<NodeId>(graph.nodes_.size() - 1);
+  return graph;
+}
+
+DialogueGraph DialogueGraph::loadScenario(const std::string& path) {
+  std::error_code sizeError;
+  std::error_code timeError;
+  const std::uint64_t sourceSize = std::filesystem::file_size(path, sizeError);
+  const auto modified = std::filesystem::last_write_time(path, timeError);
+  if (sizeError || timeError) {
+    throw std::runtime_error("Failed to open scenario: " + path);
+  }
+  const std::int64_t sourceTime = modified.time_since_epoch().count();
+  const std::string cachePath = std::filesystem::path(path).replace_extension(".dlg").string();
+
+  DialogueGraph graph;
+  if (graph.loadCache(cachePath, sourceSize, sourceTime)) {
+    return graph;
+  }
+
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Failed to open scenario: " + path);
+  }
+  const std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  graph = compile(JsonDocument::parse(text, path).root(), path);
+  graph.saveCache(cachePath, sourceSize, sourceTime);
+  return graph;
+}
+
+std::string_view DialogueGraph::text(StringId id) const {
+  return std::string_view(strings_).substr(stringOffsets_[id],
+                                           stringOffsets_[id + 1] - stringOffsets_[id]);
+}
+
+const DialogueGraph::Node& DialogueGraph::node(NodeId id) const {
+  return nodes_[id];
+}
+
+std::span<const DialogueGraph::Option> DialogueGraph::options(const Node& node) const {
+  return std::span<const Option>(options_).subspan(node.firstOption, node.optionCount);
+}
+
+std::size_t DialogueGraph::nodeCount() const {
+  return nodes_.size();
+}
+
+DialogueGraph::NodeId DialogueGraph::closingNode() const {
+  return closing_;
+}
+
+std::span<const DialogueGraph::Option> DialogueGraph::menu(Slot slot) const {
+  if (slot == Slot::None || slot == Slot::Name) {
+    return {};
+  }
+  const NodeId asking = menuNodes_[static_cast<std::size_t>(slot) - 1];
+  return asking == kNoNode ? std::span<const Option>{} : options(nodes_[asking]);
+}
+
+OrderFieldMask DialogueGraph::requiredFields() const {
+  return requiredFields_;
+}
+
+std::string_view DialogueGraph::title() const {
+  return text(title_);
+}
+
+std::string_view DialogueGraph::setting() const {
+  return text(setting_);
+}
+
+std::span<const DialogueGraph::StringId> DialogueGraph::coachingNotes() const {
+  return notes_;
+}
+
+bool DialogueGraph::loadCache(const std::string& path, std::uint64_t sourceSize,
+                              std::int64_t sourceTime) {
+  std::ifstream in(path, std::ios::binary);
+  CacheHeader header{};
+  if (!in || !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+      header.version != kCacheVersion || header.sourceSize != sourceSize ||
+      header.sourceTime != sourceTime) {
+    return false;
+  }
+
+  strings_.resize(header.stringBytes);
+  const bool complete =
+      in.read(strings_.data(), static_cast<std::streamsize>(strings_.size())) &&
+      readArray(in, stringOffsets_, std::size_t{header.stringCount} + 1) &&
+      readArray(in, nodes_, header.nodeCount) && readArray(in, options_, header.optionCount) &&
+      readArray(in, notes_, header.noteCount);
+  title_ = header.title;
+  setting_ = header.setting;
+  closing_ = header.closing;
+  std::copy(std::begin(header.menuNodes), std::end(header.menuNodes), menuNodes_.begin());
+  if (header.requiredFields > kAllOrderFields) {
+    return false;
+  }
+  requiredFields_ = static_cast<OrderFieldMask>(header.requiredFields);
+  return complete && consistent();
+}
+
+void DialogueGraph::saveCache(const std::string& path, std::uint64_t sourceSize,
+                              std::int64_t sourceTime) const {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return;
+  }
+  CacheHeader header{};
+  std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+  header.version = kCacheVersion;
+  header.sourceSize = sourceSize;
+  header.sourceTime = sourceTime;
+  header.stringBytes = static_cast<std::uint32_t>(strings_.size());
+  header.stringCount = static_cast<std::uint32_t>(stringOffsets_.size() - 1);
+  header.nodeCount = static_cast<std::uint32_t>(nodes_.size());
+  header.optionCount = static_cast<std::uint32_t>(options_.size());
+  header.noteCount = static_cast<std::uint32_t>(notes_.size());
+  header.title = title_;
+  header.setting = setting_;
+  header.closing = closing_;
+  std::copy(menuNodes_.begin(), menuNodes_.end(), std::begin(header.menuNodes));
+  header.requiredFields = requiredFields_;
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(strings_.data(), static_cast<std::streamsize>(strings_.size()));
+  writeArray(out, stringOffsets_);
+  writeArray(out, nodes_);
+  writeArray(out, options_);
+  writeArray(out, notes_);
+}
+
+bool DialogueGraph::consistent() const {
+  if (stringOffsets_.empty() || stringOffsets_.front() != 0 ||
+      stringOffsets_.back() != strings_.size() ||
+      !std::is_sorted(stringOffsets_.begin(), stringOffsets_.end()) || nodes_.empty() ||
+      closing_ >= nodes_.size()) {
+    return false;
+  }
+  const std::size_t stringCount = stringOffsets_.size() - 1;
+  const auto validNext = [&](NodeId next) { return next == kNoNode || next < nodes_.size(); };
+  for (const Node& node : nodes_) {
+    if (node.prompt >= stringCount || node.slot > Slot::Name || node.optionCount > kMaxOptions ||
+        node.firstOption > options_.size() ||
+        node.optionCount > options_.size() - node.firstOption || !validNext(node.next)) {
+      return false;
+    }
+  }
+  const bool optionsValid = std::all_of(options_.begin(), options_.end(), [&](const Option& option) {
+    return option.label < stringCount && validNext(option.next);
+  });
+  const bool menusValid = std::all_of(menuNodes_.begin(), menuNodes_.end(), [&](NodeId asking) {
+    return asking == kNoNode || asking < nodes_.size();
+  });
+  return optionsValid && menusValid && title_ < stringCount && setting_ < stringCount &&
+         std::all_of(notes_.begin(), notes_.end(), [&](StringId id) { return id < stringCount; });
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "Json.hpp"
+#include "Order.hpp"
+
+// A scenario compiled for the barista: every line of text is interned once
+// into one buffer, and nodes and options refer to text and to each other by
+// index. Scenario files are JSON (see scenarios/ at the repository root):
+//
+//   title, setting, coachingNotes   shown around the conversation
+//   menu.drinks / .sizes / .milks   option lists for the questions below
+//   script[]                        {role: "barista" | "user", line}
+//
+// Each barista line becomes a node. The user lines right after it are its
+// options; a barista line without any gets a single "Continue". A barista
+// line with "ask": "drink" | "size" | "milk" offers that menu list instead
+// and fills the order field, and "ask": "name" waits for a typed name.
+// Lines may quote the order so far with {drink}, {size}, {milk} and {name}.
+// Reaching the last node completes the conversation. An order is complete
+// once it holds every field the script asks for (requiredFields()).
+class DialogueGraph {
+ public:
+  using StringId = std::uint32_t;
+  using NodeId = std::uint32_t;
+  static constexpr NodeId kNoNode = ~NodeId{0};
+  // Options map to the number keys 1-4.
+  static constexpr std::size_t kMaxOptions = 4;
+
+  // The order field a node asks for.
+  enum class Slot : std::uint32_t { None, Drink, Size, Milk, Name };
+
+  // The order field a slot other than None fills.
+  [[nodiscard]] static constexpr OrderField field(Slot slot) {
+    return static_cast<OrderField>(static_cast<std::uint32_t>(slot) - 1);
+  }
+
+  struct Option {
+    StringId label;
+    NodeId next;
+  };
+
+  struct Node {
+    StringId prompt;
+    Slot slot;
+    std::uint32_t firstOption;
+    std::uint32_t optionCount;  // 0 when the answer is typed
+    NodeId next;                // after a typed answer
+  };
+
+  // The café's standard order: drink, size, milk, name, confirmation.
+  static const DialogueGraph& builtin();
+  // Throws std::runtime_error naming sourceName when the scenario is not
+  // one the barista can run.
+  static DialogueGraph compile(const JsonDocument::Value& scenario,
+                               std::string_view sourceName = "<scenario>");
+  // Compiles the JSON file at path, or loads the compiled copy cached next
+  // to it (same name, .dlg extension) when that was compiled from the file
+  // as it is now, same size and modification time. A fresh compile rewrites
+  // the cache; failing to write it is not an error.
+  static DialogueGraph loadScenario(const std::string& path);
+
+  [[nodiscard]] std::string_view text(StringId id) const;
+  [[nodiscard]] const Node& node(NodeId id) const;
+  [[nodiscard]] std::span<const Option> options(const Node& node) const;
+  [[nodiscard]] std::size_t nodeCount() const;
+  // First node after the last question: from here the order can be
+  // confirmed.
+  [[nodiscard]] NodeId closingNode() const;
+  // The menu list the first question for slot offers, in menu order, so an
+  // Order's item index picks the label. Empty for Slot::None, Slot::Name and
+  // lists the scenario never asks for.
+  [[nodiscard]] std::span<const Option> menu(Slot slot) const;
+  // Fields some node asks for; a script without questions requires none.
+  [[nodiscard]] OrderFieldMask requiredFields() const;
+
+  [[nodiscard]] std::string_view title() const;
+  [[nodiscard]] std::string_view setting() const;
+  [[nodiscard]] std::span<const StringId> coachingNotes() const;
+
+ private:
+  class Builder;
+
+  // Compiled file layout: header, then strings_, stringOffsets_, nodes_,
+  // options_ and notes_, in that order and with the header's counts.
+  struct CacheHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t sourceSize;
+    std::int64_t sourceTime;
+    std::uint32_t stringBytes;
+    std::uint32_t stringCount;
+    std::uint32_t nodeCount;
+    std::uint32_t optionCount;
+    std::uint32_t noteCount;
+    StringId title;
+    StringId setting;
+    NodeId closing;
+    NodeId menuNodes[3];
+    std::uint32_t requiredFields;
+  };
+  static_assert(std::is_trivially_copyable_v<CacheHeader> && std::is_trivially_copyable_v<Node> &&
+                std::is_trivially_copyable_v<Option>);
+
+  [[nodiscard]] bool loadCache(const std::string& path, std::uint64_t sourceSize,
+                               std::int64_t sourceTime);
+  void saveCache(const std::string& path, std::uint64_t sourceSize,
+                 std::int64_t sourceTime) const;
+  // Every index in range: a cache that fails this is recompiled.
+  [[nodiscard]] bool consistent() const;
+
+  std::string strings_;
+  // Start of each string in strings_, plus the end of the last one.
+  std::vector<std::uint32_t> stringOffsets_;
+  std::vector<Node> nodes_;
+  std::vector<Option> options_;
+  std::vector<StringId> notes_;
+  StringId title_{0};
+  StringId setting_{0};
+  NodeId closing_{0};
+  // First node asking for Drink, Size and Milk.
+  std::array<NodeId, 3> menuNodes_{kNoNode, kNoNode, kNoNode};
+  OrderFieldMask requiredFields_{0};
+};
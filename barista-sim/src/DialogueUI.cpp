@@ -1,12 +1,15 @@
 #include "DialogueUI.hpp"
 
 #include <algorithm>
+
+#include "RenderSnapshot.hpp"
 #include "Resources.hpp"
+#include "Utils.hpp"
 
 DialogueUI::DialogueUI() = default;
 
 void DialogueUI::initialize(const ResourceManager& resources) {
-  const auto& font = resources.font("ui");
+  const auto& font = resources.font(FontId::Ui);
 
   panel_.setSize(sf::Vector2f(1200.0f, 220.0f));
   panel_.setFillColor(sf::Color(20, 20, 26, 200));
@@ -14,6 +17,7 @@ void DialogueUI::initialize(const ResourceManager& resources) {
   panel_.setOutlineThickness(2.0f);
   panel_.setOrigin(panel_.getSize() * 0.5f);
   panel_.setPosition(640.0f, 620.0f);
+  frameLayer_.setArea(panel_.getGlobalBounds());
 
   speakerText_.setFont(font);
   speakerText_.setCharacterSize(20);
@@ -24,6 +28,7 @@ void DialogueUI::initialize(const ResourceManager& resources) {
   messageText_.setFont(font);
   messageText_.setCharacterSize(24);
   messageText_.setFillColor(sf::Color::White);
+  messageText_.setWrapWidth(panel_.getSize().x - 48.0f);
   messageText_.setPosition(speakerText_.getPosition().x,
                            speakerText_.getPosition().y + 36.0f);
 
@@ -32,6 +37,14 @@ void DialogueUI::initialize(const ResourceManager& resources) {
   hintText_.setFillColor(sf::Color(200, 200, 200));
   hintText_.setPosition(panel_.getPosition().x + panel_.getSize().x / 2.0f - 260.0f,
                         panel_.getPosition().y + panel_.getSize().y / 2.0f - 40.0f);
+
+  for (std::size_t i = 0; i < optionTexts_.size(); ++i) {
+    optionTexts_[i].setFont(font);
+    optionTexts_[i].setCharacterSize(22);
+    optionTexts_[i].setFillColor(sf::Color(180, 180, 180));
+    optionTexts_[i].setPosition(messageText_.getPosition().x,
+                                messageText_.getPosition().y + 120.0f + static_cast<float>(i) * 32.0f);
+  }
 }
 
 void DialogueUI::setVisible(bool visible) {
@@ -42,37 +55,40 @@ bool DialogueUI::isVisible() const {
   return visible_;
 }
 
-void DialogueUI::setDialogue(const std::string& speaker, const std::string& message,
-                             const std::vector<std::string>& options, bool requiresInput) {
-  speakerText_.setString(speaker);
-  fullMessage_ = message;
-  displayedMessage_.clear();
+void DialogueUI::setDialogue(std::string_view speaker, std::string_view message,
+                             std::span<const std::string_view> options, bool requiresInput) {
+  utils::assignUtf8(stringScratch_, speaker);
+  speakerText_.setString(stringScratch_);
+  utils::assignUtf8(stringScratch_, message);
+  messageText_.setString(stringScratch_);
+  messageText_.setVisibleGlyphs(0);
   revealedCount_ = 0;
   revealTimer_ = 0.0f;
   requiresInput_ = requiresInput;
-  optionTexts_.clear();
   highlightedIndex_ = 0;
   inputText_.clear();
 
-  optionTexts_.reserve(options.size());
-  for (std::size_t i = 0; i < options.size(); ++i) {
-    sf::Text option;
-    option.setFont(*messageText_.getFont());
-    option.setCharacterSize(22);
-    option.setFillColor(sf::Color(180, 180, 180));
-    option.setString(std::to_string(i + 1) + ". " + options[i]);
-    option.setPosition(messageText_.getPosition().x,
-                       messageText_.getPosition().y + 120.0f + static_cast<float>(i) * 32.0f);
-    optionTexts_.push_back(option);
+  optionCount_ = requiresInput_ ? 1 : std::min(options.size(), optionTexts_.size());
+  for (std::size_t i = 0; i < optionCount_ && !requiresInput_; ++i) {
+    labelScratch_.assign(1, static_cast<char>('1' + i));
+    labelScratch_.append(". ");
+    labelScratch_.append(options[i]);
+    utils::assignUtf8(stringScratch_, labelScratch_);
+    optionTexts_[i].setString(stringScratch_);
   }
 
-  hintText_.setString(requiresInput_ ? "Type name, Enter to confirm"
-                                     : "Press number keys or click to choose");
+  utils::assignAscii(stringScratch_, requiresInput_ ? "Type name, Enter to confirm"
+                                                    : "Press number keys or click to choose");
+  hintText_.setString(stringScratch_);
+  frameRevision_ = StaticLayer::newRevision();
   refreshOptionText();
   visible_ = true;
 }
 
-void DialogueUI::setInputText(const std::string& text) {
+void DialogueUI::setInputText(std::string_view text) {
+  if (text == inputText_) {
+    return;
+  }
   inputText_ = text;
   refreshOptionText();
 }
@@ -82,19 +98,16 @@ void DialogueUI::update(float dt) {
     return;
   }
 
-  if (revealedCount_ < fullMessage_.size()) {
-    revealTimer_ += dt * charsPerSecond_;
-    const std::size_t newCount = static_cast<std::size_t>(revealTimer_);
-    if (newCount > revealedCount_) {
-      revealedCount_ = std::min(fullMessage_.size(), newCount);
-      displayedMessage_ = fullMessage_.substr(0, revealedCount_);
-      messageText_.setString(displayedMessage_);
-    }
-  } else {
-    messageText_.setString(fullMessage_);
+  if (revealedCount_ >= messageText_.glyphCount()) {
+    return;
   }
 
-  refreshOptionText();
+  revealTimer_ += dt * charsPerSecond_;
+  const auto newCount = static_cast<std::size_t>(revealTimer_);
+  if (newCount > revealedCount_) {
+    revealedCount_ = std::min(messageText_.glyphCount(), newCount);
+    messageText_.setVisibleGlyphs(revealedCount_);
+  }
 }
 
 void DialogueUI::draw(sf::RenderTarget& target) const {
@@ -102,31 +115,52 @@ void DialogueUI::draw(sf::RenderTarget& target) const {
     return;
   }
 
-  target.draw(panel_);
-  target.draw(speakerText_);
+  frameLayer_.draw(target, frameRevision_, [this](sf::RenderTarget& frame) {
+    frame.draw(panel_);
+    frame.draw(speakerText_);
+    frame.draw(hintText_);
+  });
   target.draw(messageText_);
-  for (const auto& option : optionTexts_) {
-    target.draw(option);
+  for (std::size_t i = 0; i < optionCount_; ++i) {
+    target.draw(optionTexts_[i]);
+  }
+}
+
+void DialogueUI::capture(RenderSnapshot& snapshot) const {
+  if (!visible_) {
+    return;
+  }
+
+  snapshot.beginLayer(frameLayer_.area(), frameRevision_);
+  snapshot.add(panel_);
+  snapshot.add(speakerText_);
+  snapshot.add(hintText_);
+  snapshot.endLayer();
+  snapshot.add(messageText_);
+  for (std::size_t i = 0; i < optionCount_; ++i) {
+    snapshot.add(optionTexts_[i]);
   }
-  target.draw(hintText_);
 }
 
 void DialogueUI::skipReveal() {
-  revealedCount_ = fullMessage_.size();
-  displayedMessage_ = fullMessage_;
-  messageText_.setString(fullMessage_);
+  revealedCount_ = messageText_.glyphCount();
+  messageText_.setVisibleGlyphs(revealedCount_);
 }
 
 bool DialogueUI::isRevealed() const {
-  return revealedCount_ >= fullMessage_.size();
+  return revealedCount_ >= messageText_.glyphCount();
 }
 
 void DialogueUI::highlightOption(std::size_t index) {
-  if (optionTexts_.empty()) {
+  if (optionCount_ == 0) {
     highlightedIndex_ = 0;
     return;
   }
-  highlightedIndex_ = std::min(index, optionTexts_.size() - 1);
+  const std::size_t clamped = std::min(index, optionCount_ - 1);
+  if (clamped == highlightedIndex_) {
+    return;
+  }
+  highlightedIndex_ = clamped;
   refreshOptionText();
 }
 
@@ -135,7 +169,7 @@ std::size_t DialogueUI::highlightedOption() const {
 }
 
 std::size_t DialogueUI::optionCount() const {
-  return optionTexts_.size();
+  return optionCount_;
 }
 
 bool DialogueUI::requiresTextInput() const {
@@ -143,21 +177,17 @@ bool DialogueUI::requiresTextInput() const {
 }
 
 void DialogueUI::refreshOptionText() {
-  for (std::size_t i = 0; i < optionTexts_.size(); ++i) {
+  for (std::size_t i = 0; i < optionCount_; ++i) {
     optionTexts_[i].setFillColor(i == highlightedIndex_ ? sf::Color::White
                                                         : sf::Color(180, 180, 180));
   }
 
   if (requiresInput_) {
-    if (optionTexts_.empty()) {
-      sf::Text option;
-      option.setFont(*messageText_.getFont());
-      option.setCharacterSize(22);
-      option.setPosition(messageText_.getPosition().x,
-                         messageText_.getPosition().y + 120.0f);
-      optionTexts_.push_back(option);
-    }
-    optionTexts_[0].setString("Name: " + inputText_ + "_");
+    labelScratch_.assign("Name: ");
+    labelScratch_.append(inputText_);
+    labelScratch_.push_back('_');
+    utils::assignUtf8(stringScratch_, labelScratch_);
+    optionTexts_[0].setString(stringScratch_);
     optionTexts_[0].setFillColor(sf::Color::White);
   }
 }
@@ -1,11 +1,25 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <span>
 #include <string>
-#include <vector>
+#include <string_view>
 
+#include "DialogueGraph.hpp"
+#include "StaticLayer.hpp"
+#include "TypewriterText.hpp"
+
+class RenderSnapshot;
 class ResourceManager;
 
+// The message is laid out once per setDialogue() and revealed by growing the
+// visible glyph count, so a typing frame costs the same for any line length.
+// Option colours are only refreshed when the highlight or typed input changes.
+// Option texts are a fixed pool styled once in initialize(); a new line only
+// rewrites their strings, reusing their capacity. The panel, speaker and hint
+// only change with the line, so they are drawn from a cached frame layer.
 class DialogueUI {
  public:
   DialogueUI();
@@ -14,12 +28,14 @@ class DialogueUI {
   void setVisible(bool visible);
   [[nodiscard]] bool isVisible() const;
 
-  void setDialogue(const std::string& speaker, const std::string& message,
-                   const std::vector<std::string>& options, bool requiresInput);
-  void setInputText(const std::string& text);
+  // Options past DialogueGraph::kMaxOptions are not shown.
+  void setDialogue(std::string_view speaker, std::string_view message,
+                   std::span<const std::string_view> options, bool requiresInput);
+  void setInputText(std::string_view text);
 
   void update(float dt);
   void draw(sf::RenderTarget& target) const;
+  void capture(RenderSnapshot& snapshot) const;
 
   void skipReveal();
   [[nodiscard]] bool isRevealed() const;
@@ -35,18 +51,23 @@ class DialogueUI {
   bool visible_{false};
   bool requiresInput_{false};
 
+  // The frame layer: panel, speaker and hint.
   sf::RectangleShape panel_;
   sf::Text speakerText_;
-  sf::Text messageText_;
+  TypewriterText messageText_;
   sf::Text hintText_;
-  std::vector<sf::Text> optionTexts_;
+  std::array<sf::Text, DialogueGraph::kMaxOptions> optionTexts_;
+  std::size_t optionCount_{0};
+  std::uint64_t frameRevision_{StaticLayer::newRevision()};
+  // Render cache only; draw() stays logically const.
+  mutable StaticLayer frameLayer_;
 
-  std::string fullMessage_;
-  std::string displayedMessage_;
   float revealTimer_{0.0f};
   float charsPerSecond_{45.0f};
   std::size_t revealedCount_{0};
   std::size_t highlightedIndex_{0};
   std::string inputText_;
+  std::string labelScratch_;
+  sf::String stringScratch_;
 };
 
@@ -0,0 +1,151 @@
+#include "Ecs.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+void World::destroy(EntityId entity) {
+  if (find(entity) == nullptr) {
+    return;
+  }
+  Record& record = records_[entity.index];
+  freeRow(record.archetype, record.row);
+  record.alive = false;
+  ++record.generation;
+  freeIndices_.push_back(entity.index);
+  --alive_;
+}
+
+void World::clear() {
+  archetypes_.clear();
+  archetypeIndex_.clear();
+  records_.clear();
+  freeIndices_.clear();
+  alive_ = 0;
+}
+
+bool World::alive(EntityId entity) const {
+  return find(entity) != nullptr;
+}
+
+std::size_t World::size() const {
+  return alive_;
+}
+
+std::uint32_t World::nextComponentType() {
+  static std::atomic<std::uint32_t> next{0};
+  const std::uint32_t type = next++;
+  if (type >= kMaxComponentTypes) {
+    throw std::runtime_error("World supports at most 64 component types");
+  }
+  return type;
+}
+
+const World::Record* World::find(EntityId entity) const {
+  if (entity.index >= records_.size()) {
+    return nullptr;
+  }
+  const Record& record = records_[entity.index];
+  return record.alive && record.generation == entity.generation ? &record : nullptr;
+}
+
+std::uint32_t World::archetypeFor(Mask mask) {
+  if (const auto found = archetypeIndex_.find(mask); found != archetypeIndex_.end()) {
+    return found->second;
+  }
+
+  Archetype archetype;
+  archetype.mask = mask;
+  archetype.columnOf.fill(kNoColumn);
+  std::size_t rowBytes = sizeof(EntityId);
+  std::size_t padding = 0;
+  for (std::uint32_t type = 0; type < kMaxComponentTypes; ++type) {
+    if ((mask & (Mask{1} << type)) != 0) {
+      archetype.columnOf[type] = static_cast<std::uint8_t>(archetype.columns.size());
+      archetype.columns.push_back({type, typeSize_[type], 0});
+      rowBytes += typeSize_[type];
+      padding += typeAlign_[type];
+    }
+  }
+  // Columns follow the entity ids, each aligned for its type; budgeting the
+  // worst-case padding up front keeps the last one inside the chunk.
+  if (rowBytes + padding > kChunkBytes) {
+    throw std::runtime_error("Entity components do not fit in one World chunk");
+  }
+  archetype.capacity = static_cast<std::uint32_t>((kChunkBytes - padding) / rowBytes);
+  std::size_t offset = sizeof(EntityId) * archetype.capacity;
+  for (Column& column : archetype.columns) {
+    const std::size_t align = typeAlign_[column.type];
+    offset = (offset + align - 1) / align * align;
+    column.offset = static_cast<std::uint32_t>(offset);
+    offset += static_cast<std::size_t>(column.size) * archetype.capacity;
+  }
+
+  const auto index = static_cast<std::uint32_t>(archetypes_.size());
+  archetypes_.push_back(std::move(archetype));
+  archetypeIndex_.emplace(mask, index);
+  return index;
+}
+
+std::uint32_t World::allocateRow(std::uint32_t archetypeIndex, EntityId entity) {
+  Archetype& archetype = archetypes_[archetypeIndex];
+  const std::uint32_t row = archetype.size;
+  const std::uint32_t chunk = row / archetype.capacity;
+  if (chunk == archetype.chunks.size()) {
+    // operator new aligns for max_align_t, which covers every component.
+    archetype.chunks.push_back(std::make_unique_for_overwrite<std::byte[]>(kChunkBytes));
+  }
+  std::memcpy(archetype.chunks[chunk].get() + sizeof(EntityId) * (row % archetype.capacity),
+              &entity, sizeof(EntityId));
+  ++archetype.size;
+  return row;
+}
+
+void World::freeRow(std::uint32_t archetypeIndex, std::uint32_t row) {
+  Archetype& archetype = archetypes_[archetypeIndex];
+  const std::uint32_t last = archetype.size - 1;
+  if (row != last) {
+    std::byte* to = archetype.chunks[row / archetype.capacity].get();
+    const std::byte* from = archetype.chunks[last / archetype.capacity].get();
+    const std::uint32_t toSlot = row % archetype.capacity;
+    const std::uint32_t fromSlot = last % archetype.capacity;
+
+    EntityId moved;
+    std::memcpy(&moved, from + sizeof(EntityId) * fromSlot, sizeof(EntityId));
+    std::memcpy(to + sizeof(EntityId) * toSlot, &moved, sizeof(EntityId));
+    for (const Column& column : archetype.columns) {
+      std::memcpy(to + column.offset + std::size_t{column.size} * toSlot,
+                  from + column.offset + std::size_t{column.size} * fromSlot, column.size);
+    }
+    records_[moved.index].row = row;
+  }
+  --archetype.size;
+}
+
+void World::moveTo(EntityId entity, Mask mask) {
+  Record& record = records_[entity.index];
+  const std::uint32_t from = record.archetype;
+  const std::uint32_t fromRow = record.row;
+  const std::uint32_t to = archetypeFor(mask);
+  const std::uint32_t toRow = allocateRow(to, entity);
+
+  for (const Column& column : archetypes_[to].columns) {
+    if (const std::byte* source = component(from, fromRow, column.type)) {
+      std::memcpy(component(to, toRow, column.type), source, column.size);
+    }
+  }
+  freeRow(from, fromRow);
+  record.archetype = to;
+  record.row = toRow;
+}
+
+std::byte* World::component(std::uint32_t archetypeIndex, std::uint32_t row,
+                            std::uint32_t type) const {
+  const Archetype& archetype = archetypes_[archetypeIndex];
+  const std::uint8_t column = archetype.columnOf[type];
+  if (column == kNoColumn) {
+    return nullptr;
+  }
+  const Column& info = archetype.columns[column];
+  return archetype.chunks[row / archetype.capacity].get() + info.offset +
+         std::size_t{info.size} * (row % archetype.capacity);
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Handle to an entity in a World. The generation tells a reused slot apart
+// from the entity that held it before.
+struct EntityId {
+  std::uint32_t index{~std::uint32_t{0}};
+  std::uint32_t generation{0};
+
+  friend bool operator==(const EntityId&, const EntityId&) = default;
+};
+
+// Entity-component store with archetype chunks. Entities with the same set
+// of component types share an archetype, stored as a list of 16 KiB chunks
+// in which every component type is its own packed array; a system walks only
+// the arrays it asks for, front to back. Adding or removing a component
+// moves the entity to another archetype. Destroying one moves the
+// archetype's last entity into the hole, so chunks stay full.
+//
+// Components are plain data (trivially copyable, at most 64 types): they move
+// between chunks with memcpy and are never destroyed. Entities must not be
+// created, destroyed or change components while their archetype is being
+// iterated.
+class World {
+ public:
+  template <typename... Components>
+  EntityId create(const Components&... components);
+  void destroy(EntityId entity);
+  void clear();
+
+  [[nodiscard]] bool alive(EntityId entity) const;
+  [[nodiscard]] std::size_t size() const;
+
+  template <typename T>
+  [[nodiscard]] bool has(EntityId entity) const;
+  // Null when the entity is gone or lacks T.
+  template <typename T>
+  [[nodiscard]] T* get(EntityId entity);
+  template <typename T>
+  [[nodiscard]] const T* get(EntityId entity) const;
+  // Adds T, or overwrites it when the entity already has one.
+  template <typename T>
+  void add(EntityId entity, const T& component);
+  template <typename T>
+  void remove(EntityId entity);
+
+  // Calls fn(count, Ts*...) once per chunk holding all of Ts, with the
+  // chunk's packed arrays.
+  template <typename... Ts, typename Fn>
+  void eachChunk(Fn&& fn);
+  template <typename... Ts, typename Fn>
+  void eachChunk(Fn&& fn) const;
+  // Calls fn(Ts&...) for every entity holding all of Ts.
+  template <typename... Ts, typename Fn>
+  void each(Fn&& fn);
+  template <typename... Ts, typename Fn>
+  void each(Fn&& fn) const;
+
+ private:
+  using Mask = std::uint64_t;
+  static constexpr std::size_t kChunkBytes = 16 * 1024;
+  static constexpr std::size_t kMaxComponentTypes = 64;
+  static constexpr std::uint8_t kNoColumn = 0xff;
+
+  struct Column {
+    std::uint32_t type;
+    std::uint32_t size;
+    std::uint32_t offset;
+  };
+
+  struct Archetype {
+    Mask mask{0};
+    std::vector<Column> columns;
+    // Column index per component type, kNoColumn when absent.
+    std::array<std::uint8_t, kMaxComponentTypes> columnOf{};
+    std::uint32_t capacity{0};
+    std::uint32_t size{0};
+    // Each chunk starts with the EntityId of every row, then the columns.
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+  };
+
+  struct Record {
+    std::uint32_t generation{0};
+    std::uint32_t archetype{0};
+    std::uint32_t row{0};
+    bool alive{false};
+  };
+
+  static std::uint32_t nextComponentType();
+  template <typename T>
+  static std::uint32_t componentType();
+  // Like componentType(), and remembers T's size for building archetypes.
+  template <typename T>
+  std::uint32_t registerType();
+
+  [[nodiscard]] const Record* find(EntityId entity) const;
+  std::uint32_t archetypeFor(Mask mask);
+  // Appends a row for entity and returns it; the components are left unset.
+  std::uint32_t allocateRow(std::uint32_t archetype, EntityId entity);
+  // Fills row with the archetype's last row and drops the last row.
+  void freeRow(std::uint32_t archetype, std::uint32_t row);
+  void moveTo(EntityId entity, Mask mask);
+  [[nodiscard]] std::byte* component(std::uint32_t archetype, std::uint32_t row,
+                                     std::uint32_t type) const;
+
+  template <typename... Ts, typename Self, typename Fn>
+  static void visitChunks(Self& self, Fn& fn);
+
+  std::vector<Archetype> archetypes_;
+  std::unordered_map<Mask, std::uint32_t> archetypeIndex_;
+  std::vector<Record> records_;
+  std::vector<std::uint32_t> freeIndices_;
+  std::size_t alive_{0};
+  std::array<std::uint32_t, kMaxComponentTypes> typeSize_{};
+  std::array<std::uint32_t, kMaxComponentTypes> typeAlign_{};
+};
+
+template <typename T>
+std::uint32_t World::componentType() {
+  static_assert(std::is_trivially_copyable_v<T>, "components must be plain data");
+  static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned components");
+  static const std::uint32_t type = nextComponentType();
+  return type;
+}
+
+template <typename T>
+std::uint32_t World::registerType() {
+  const std::uint32_t type = componentType<T>();
+  typeSize_[type] = sizeof(T);
+  typeAlign_[type] = alignof(T);
+  return type;
+}
+
+template <typename... Components>
+EntityId World::create(const Components&... components) {
+  const Mask mask = ((Mask{1} << registerType<Components>()) | ... | Mask{0});
+
+  EntityId entity;
+  if (freeIndices_.empty()) {
+    entity.index = static_cast<std::uint32_t>(records_.size());
+    records_.emplace_back();
+  } else {
+    entity.index = freeIndices_.back();
+    freeIndices_.pop_back();
+  }
+  Record& record = records_[entity.index];
+  entity.generation = record.generation;
+  record.alive = true;
+  record.archetype = archetypeFor(mask);
+  record.row = allocateRow(record.archetype, entity);
+  ++alive_;
+
+  (std::memcpy(component(record.archetype, record.row, componentType<Components>()),
+               &components, sizeof(Components)),
+   ...);
+  return entity;
+}
+
+template <typename T>
+bool World::has(EntityId entity) const {
+  const Record* record = find(entity);
+  return record != nullptr &&
+         (archetypes_[record->archetype].mask & (Mask{1} << componentType<T>())) != 0;
+}
+
+template <typename T>
+T* World::get(EntityId entity) {
+  const Record* record = find(entity);
+  if (record == nullptr) {
+    return nullptr;
+  }
+  return reinterpret_cast<T*>(component(record->archetype, record->row, componentType<T>()));
+}
+
+template <typename T>
+const T* World::get(EntityId entity) const {
+  return const_cast<World*>(this)->get<T>(entity);
+}
+
+template <typename T>
+void World::add(EntityId entity, const T& value) {
+  const Record* record = find(entity);
+  if (record == nullptr) {
+    return;
+  }
+  const Mask bit = Mask{1} << registerType<T>();
+  if ((archetypes_[record->archetype].mask & bit) == 0) {
+    moveTo(entity, archetypes_[record->archetype].mask | bit);
+  }
+  std::memcpy(component(record->archetype, record->row, componentType<T>()), &value, sizeof(T));
+}
+
+template <typename T>
+void World::remove(EntityId entity) {
+  const Record* record = find(entity);
+  const Mask bit = Mask{1} << componentType<T>();
+  if (record != nullptr && (archetypes_[record->archetype].mask & bit) != 0) {
+    moveTo(entity, archetypes_[record->archetype].mask & ~bit);
+  }
+}
+
+template <typename... Ts, typename Self, typename Fn>
+void World::visitChunks(Self& self, Fn& fn) {
+  const Mask required = ((Mask{1} << componentType<Ts>()) | ... | Mask{0});
+  for (const Archetype& archetype : self.archetypes_) {
+    if ((archetype.mask & required) != required || archetype.size == 0) {
+      continue;
+    }
+    const std::array<std::uint32_t, sizeof...(Ts)> offsets{
+        archetype.columns[archetype.columnOf[componentType<Ts>()]].offset...};
+    for (std::size_t chunk = 0; chunk < archetype.chunks.size(); ++chunk) {
+      const std::size_t first = chunk * archetype.capacity;
+      if (first >= archetype.size) {
+        break;
+      }
+      const std::size_t count = std::min<std::size_t>(archetype.capacity, archetype.size - first);
+      std::byte* bytes = archetype.chunks[chunk].get();
+      [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        fn(count, reinterpret_cast<std::conditional_t<std::is_const_v<Self>, const Ts*, Ts*>>(
+                      bytes + offsets[Is])...);
+      }(std::index_sequence_for<Ts...>{});
+    }
+  }
+}
+
+template <typename... Ts, typename Fn>
+void World::eachChunk(Fn&& fn) {
+  visitChunks<Ts...>(*this, fn);
+}
+
+template <typename... Ts, typename Fn>
+void World::eachChunk(Fn&& fn) const {
+  visitChunks<Ts...>(*this, fn);
+}
+
+template <typename... Ts, typename Fn>
+void World::each(Fn&& fn) {
+  eachChunk<Ts...>([&fn](std::size_t count, Ts*... arrays) {
+    for (std::size_t i = 0; i < count; ++i) {
+      fn(arrays[i]...);
+    }
+  });
+}
+
+template <typename... Ts, typename Fn>
+void World::each(Fn&& fn) const {
+  eachChunk<Ts...>([&fn](std::size_t count, const Ts*... arrays) {
+    for (std::size_t i = 0; i < count; ++i) {
+      fn(arrays[i]...);
+    }
+  });
+}
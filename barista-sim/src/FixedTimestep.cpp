@@ -0,0 +1,61 @@
+#include "FixedTimestep.hpp"
+
+#include <algorithm>
+
+namespace {
+// Absorbs rounding so a frame of exactly one step always yields one tick.
+constexpr double kTickEpsilon = 1e-6;
+}  // namespace
+
+FixedTimestep::FixedTimestep(float step, TimeStepPolicy policy, unsigned maxTicksPerFrame,
+                             float maxBacklogSeconds)
+    : step_(step),
+      policy_(policy),
+      maxTicksPerFrame_(std::max(1U, maxTicksPerFrame)),
+      maxBacklogSeconds_(std::max(step, maxBacklogSeconds)) {}
+
+unsigned FixedTimestep::advance(float frameSeconds) {
+  const double step = step_;
+  accumulator_ += std::max(0.0f, frameSeconds);
+
+  // Time beyond the backlog limit is never simulated, whatever the policy.
+  if (accumulator_ > maxBacklogSeconds_) {
+    const auto excess = static_cast<std::uint64_t>((accumulator_ - maxBacklogSeconds_) / step);
+    stats_.droppedTicks += excess;
+    accumulator_ -= static_cast<double>(excess) * step;
+  }
+
+  const auto owed = static_cast<unsigned>((accumulator_ + kTickEpsilon) / step);
+  const unsigned ticks = std::min(owed, maxTicksPerFrame_);
+  if (owed > ticks) {
+    const unsigned excess = owed - ticks;
+    if (policy_ == TimeStepPolicy::CatchUp) {
+      stats_.droppedTicks += excess;
+      accumulator_ -= static_cast<double>(excess) * step;
+    } else {
+      stats_.dilatedFrames += 1;
+    }
+  }
+
+  accumulator_ = std::max(0.0, accumulator_ - static_cast<double>(ticks) * step);
+  stats_.ticks += ticks;
+  stats_.maxBacklogSeconds =
+      std::max(stats_.maxBacklogSeconds, static_cast<float>(accumulator_));
+  return ticks;
+}
+
+void FixedTimestep::recordDroppedTicks(std::uint64_t count) {
+  stats_.droppedTicks += count;
+}
+
+float FixedTimestep::step() const {
+  return step_;
+}
+
+float FixedTimestep::alpha() const {
+  return static_cast<float>(std::clamp(accumulator_ / step_, 0.0, 1.0));
+}
+
+const TimeStepStats& FixedTimestep::stats() const {
+  return stats_;
+}
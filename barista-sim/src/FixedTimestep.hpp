@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+// What to do when a frame took longer than the simulation can catch up on.
+enum class TimeStepPolicy : std::uint8_t {
+  // Run every owed tick in one burst, up to maxTicksPerFrame; drop the rest.
+  CatchUp,
+  // Run at most maxTicksPerFrame ticks and carry the remainder into later
+  // frames, so simulated time briefly lags wall time instead of bursting.
+  // Only a backlog beyond maxBacklogSeconds is dropped.
+  Dilate
+};
+
+struct TimeStepStats {
+  std::uint64_t ticks{0};
+  std::uint64_t droppedTicks{0};
+  std::uint64_t dilatedFrames{0};  // frames that left owed ticks for later
+  float maxBacklogSeconds{0.0f};
+};
+
+// Fixed-step accumulator for the main loop. advance() turns wall-clock frame
+// time into a tick count, alpha() is how far the frame sits between the last
+// two ticks and is used to interpolate rendering. Nothing is dropped silently:
+// every skipped tick is counted in stats().
+class FixedTimestep {
+ public:
+  FixedTimestep(float step, TimeStepPolicy policy, unsigned maxTicksPerFrame,
+                float maxBacklogSeconds = 0.25f);
+
+  [[nodiscard]] unsigned advance(float frameSeconds);
+  void recordDroppedTicks(std::uint64_t count);
+
+  [[nodiscard]] float step() const;
+  [[nodiscard]] float alpha() const;
+  [[nodiscard]] const TimeStepStats& stats() const;
+
+ private:
+  float step_;
+  TimeStepPolicy policy_;
+  unsigned maxTicksPerFrame_;
+  float maxBacklogSeconds_;
+  double accumulator_{0.0};
+  TimeStepStats stats_;
+};
@@ -0,0 +1,211 @@
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include "AllocationCounter.hpp"
+
+namespace {
+constexpr const char* kPhaseNames[] = {"events", "scene_switch", "update", "render", "present"};
+static_assert(std::size(kPhaseNames) == static_cast<std::size_t>(FramePhase::Count));
+
+[[nodiscard]] bool isRecorded(std::int64_t beginUs, std::int64_t endUs) {
+  return beginUs >= 0 && endUs >= beginUs;
+}
+
+// Nearest-rank percentile over an already sorted sample set.
+[[nodiscard]] double percentile(const std::vector<double>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+  return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+void writeSummaryRow(std::ofstream& out, const char* name, std::vector<double>& samplesMs,
+                     double budgetMs) {
+  std::sort(samplesMs.begin(), samplesMs.end());
+  double total = 0.0;
+  std::size_t overBudget = 0;
+  for (const double sample : samplesMs) {
+    total += sample;
+    if (sample > budgetMs) {
+      ++overBudget;
+    }
+  }
+  const double mean = samplesMs.empty() ? 0.0 : total / static_cast<double>(samplesMs.size());
+  const double max = samplesMs.empty() ? 0.0 : samplesMs.back();
+
+  out << name << ',' << samplesMs.size() << ',' << mean << ',' << percentile(samplesMs, 0.50)
+      << ',' << percentile(samplesMs, 0.95) << ',' << percentile(samplesMs, 0.99) << ',' << max
+      << ',' << overBudget << '\n';
+}
+}  // namespace
+
+FrameProfiler::FrameProfiler(std::size_t capacityFrames)
+    : origin_(Clock::now()), frames_(std::max<std::size_t>(1, capacityFrames)) {}
+
+void FrameProfiler::setEnabled(bool enabled) {
+  enabled_ = enabled;
+  current_ = nullptr;
+}
+
+bool FrameProfiler::enabled() const {
+  return enabled_;
+}
+
+void FrameProfiler::beginFrame() {
+  if (!enabled_) {
+    return;
+  }
+
+  FrameRecord& record = frames_[head_];
+  record.index = frameIndex_++;
+  record.frame = {nowUs(), -1};
+  record.phases.fill({-1, -1});
+  record.tickCount = 0;
+  record.allocationsAtBegin = allocationCount();
+  record.allocations = 0;
+  current_ = &record;
+}
+
+void FrameProfiler::endFrame() {
+  if (!current_) {
+    return;
+  }
+
+  current_->frame.endUs = nowUs();
+  current_->allocations = allocationCount() - current_->allocationsAtBegin;
+  current_ = nullptr;
+  head_ = (head_ + 1) % frames_.size();
+  count_ = std::min(count_ + 1, frames_.size());
+}
+
+void FrameProfiler::beginPhase(FramePhase phase) {
+  if (current_) {
+    current_->phases[static_cast<std::size_t>(phase)].beginUs = nowUs();
+  }
+}
+
+void FrameProfiler::endPhase(FramePhase phase) {
+  if (current_) {
+    current_->phases[static_cast<std::size_t>(phase)].endUs = nowUs();
+  }
+}
+
+void FrameProfiler::beginTick() {
+  if (current_ && current_->tickCount < kMaxTicksPerFrame) {
+    current_->ticks[current_->tickCount] = {nowUs(), -1};
+  }
+}
+
+void FrameProfiler::endTick() {
+  if (!current_) {
+    return;
+  }
+  if (current_->tickCount < kMaxTicksPerFrame) {
+    current_->ticks[current_->tickCount].endUs = nowUs();
+  }
+  ++current_->tickCount;
+}
+
+std::size_t FrameProfiler::recordedFrames() const {
+  return count_;
+}
+
+bool FrameProfiler::writeChromeTrace(const std::string& path) const {
+  std::ofstream out(path);
+  if (!out) {
+    return false;
+  }
+
+  bool first = true;
+  auto writeEvent = [&](const char* name, const Span& span, const FrameRecord& record) {
+    if (!isRecorded(span.beginUs, span.endUs)) {
+      return;
+    }
+    out << (first ? "\n" : ",\n") << R"({"name":")" << name
+        << R"(","cat":"frame","ph":"X","pid":1,"tid":1,"ts":)" << span.beginUs
+        << R"(,"dur":)" << (span.endUs - span.beginUs) << R"(,"args":{"frame":)" << record.index
+        << R"(,"allocations":)" << record.allocations << "}}";
+    first = false;
+  };
+
+  out << R"({"displayTimeUnit":"ms","traceEvents":[)";
+  for (std::size_t age = 0; age < count_; ++age) {
+    const FrameRecord& record = recordAt(age);
+    writeEvent("frame", record.frame, record);
+    for (std::size_t phase = 0; phase < record.phases.size(); ++phase) {
+      writeEvent(kPhaseNames[phase], record.phases[phase], record);
+    }
+    const std::size_t ticks = std::min<std::size_t>(record.tickCount, kMaxTicksPerFrame);
+    for (std::size_t tick = 0; tick < ticks; ++tick) {
+      writeEvent("tick", record.ticks[tick], record);
+    }
+  }
+  out << "\n]}\n";
+  return static_cast<bool>(out);
+}
+
+bool FrameProfiler::writeSummaryCsv(const std::string& path, float frameBudgetSeconds) const {
+  std::ofstream out(path);
+  if (!out) {
+    return false;
+  }
+
+  auto toMs = [](const Span& span) { return static_cast<double>(span.endUs - span.beginUs) / 1000.0; };
+
+  std::vector<double> frameSamples;
+  std::vector<double> tickSamples;
+  std::vector<double> allocationSamples;
+  std::array<std::vector<double>, static_cast<std::size_t>(FramePhase::Count)> phaseSamples;
+  for (std::size_t age = 0; age < count_; ++age) {
+    const FrameRecord& record = recordAt(age);
+    if (isRecorded(record.frame.beginUs, record.frame.endUs)) {
+      frameSamples.push_back(toMs(record.frame));
+      allocationSamples.push_back(static_cast<double>(record.allocations));
+    }
+    for (std::size_t phase = 0; phase < record.phases.size(); ++phase) {
+      const Span& span = record.phases[phase];
+      if (isRecorded(span.beginUs, span.endUs)) {
+        phaseSamples[phase].push_back(toMs(span));
+      }
+    }
+    const std::size_t ticks = std::min<std::size_t>(record.tickCount, kMaxTicksPerFrame);
+    for (std::size_t tick = 0; tick < ticks; ++tick) {
+      tickSamples.push_back(toMs(record.ticks[tick]));
+    }
+  }
+
+  const double budgetMs = static_cast<double>(frameBudgetSeconds) * 1000.0;
+  out << std::fixed << std::setprecision(3);
+  out << "phase,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,over_budget\n";
+  writeSummaryRow(out, "frame", frameSamples, budgetMs);
+  for (std::size_t phase = 0; phase < phaseSamples.size(); ++phase) {
+    writeSummaryRow(out, kPhaseNames[phase], phaseSamples[phase], budgetMs);
+  }
+  writeSummaryRow(out, "tick", tickSamples, budgetMs);
+  if (allocationCountingEnabled()) {
+    writeSummaryRow(out, "allocations", allocationSamples, 0.0);
+  }
+  return static_cast<bool>(out);
+}
+
+FrameProfiler::PhaseScope::PhaseScope(FrameProfiler& profiler, FramePhase phase)
+    : profiler_(profiler), phase_(phase) {
+  profiler_.beginPhase(phase_);
+}
+
+FrameProfiler::PhaseScope::~PhaseScope() {
+  profiler_.endPhase(phase_);
+}
+
+std::int64_t FrameProfiler::nowUs() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - origin_).count();
+}
+
+const FrameProfiler::FrameRecord& FrameProfiler::recordAt(std::size_t age) const {
+  return frames_[(head_ + frames_.size() - count_ + age) % frames_.size()];
+}
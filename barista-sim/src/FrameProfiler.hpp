@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Phases of one App::run iteration, in the order they execute.
+enum class FramePhase : std::uint8_t {
+  Events,
+  SceneSwitch,
+  Update,
+  Render,
+  Present,
+  Count
+};
+
+// Records per-phase timings for the last N frames into a ring buffer that is
+// allocated once up front. Nested fixed-step update ticks are kept per frame
+// (up to kMaxTicksPerFrame). Dumps Chrome-trace JSON (loadable in Perfetto or
+// chrome://tracing) and a CSV with p50/p95/p99 per phase. Builds with
+// allocation counting also get an "allocations" row: heap allocations per
+// frame, with over_budget counting frames that allocated at all.
+class FrameProfiler {
+ public:
+  static constexpr std::size_t kMaxTicksPerFrame = 16;
+
+  explicit FrameProfiler(std::size_t capacityFrames = 600);
+
+  void setEnabled(bool enabled);
+  [[nodiscard]] bool enabled() const;
+
+  void beginFrame();
+  void endFrame();
+  void beginPhase(FramePhase phase);
+  void endPhase(FramePhase phase);
+  void beginTick();
+  void endTick();
+
+  [[nodiscard]] std::size_t recordedFrames() const;
+
+  bool writeChromeTrace(const std::string& path) const;
+  bool writeSummaryCsv(const std::string& path, float frameBudgetSeconds) const;
+
+  class PhaseScope {
+   public:
+    PhaseScope(FrameProfiler& profiler, FramePhase phase);
+    ~PhaseScope();
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+   private:
+    FrameProfiler& profiler_;
+    FramePhase phase_;
+  };
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Span {
+    std::int64_t beginUs{0};
+    std::int64_t endUs{0};
+  };
+
+  struct FrameRecord {
+    std::uint64_t index{0};
+    Span frame;
+    std::array<Span, static_cast<std::size_t>(FramePhase::Count)> phases{};
+    std::array<Span, kMaxTicksPerFrame> ticks{};
+    std::uint32_t tickCount{0};
+    std::uint64_t allocationsAtBegin{0};
+    std::uint64_t allocations{0};
+  };
+
+  [[nodiscard]] std::int64_t nowUs() const;
+  [[nodiscard]] const FrameRecord& recordAt(std::size_t age) const;
+
+  bool enabled_{false};
+  Clock::time_point origin_;
+  std::vector<FrameRecord> frames_;
+  std::size_t head_{0};
+  std::size_t count_{0};
+  std::uint64_t frameIndex_{0};
+  FrameRecord* current_{nullptr};
+};
@@ -1,13 +1,26 @@
 #include "HUD.hpp"
 
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
 #include "Order.hpp"
+#include "RenderSnapshot.hpp"
 #include "Resources.hpp"
+#include "Utils.hpp"
+
+namespace {
+constexpr sf::Uint32 kChecked = 0x2705;    // ✅
+constexpr sf::Uint32 kUnchecked = 0x2B1C;  // ⬜
+constexpr sf::Uint32 kBullet = 0x2022;     // •
+
+// In OrderField order, so label n is checked by that field's bit.
+constexpr const char* kChecklistLabels[] = {" Drink\n", " Size\n", " Milk\n", " Name"};
+static_assert(std::size(kChecklistLabels) == kOrderFieldCount);
+}  // namespace
 
 void HUD::initialize(const ResourceManager& resources) {
-  const auto& font = resources.font("ui");
+  const auto& font = resources.font(FontId::Ui);
 
   clockText_.setFont(font);
   clockText_.setCharacterSize(24);
@@ -29,54 +42,98 @@ void HUD::initialize(const ResourceManager& resources) {
   hintText_.setCharacterSize(18);
   hintText_.setFillColor(sf::Color(200, 200, 200));
   hintText_.setPosition(980.0f, 120.0f);
-  hintText_.setString("E to interact");
+
+  interactHint_ = "E to interact";
+  selectHint_ = "1-4 to select ";
+  selectHint_ += sf::String(kBullet);
+  selectHint_ += " Enter to confirm";
+  hintText_.setString(interactHint_);
+  displayedHint_ = DefaultHint::Interact;
 }
 
 void HUD::update(float elapsedSeconds, const Order& order, bool interacting) {
-  std::ostringstream oss;
-  oss << "Time: " << std::fixed << std::setprecision(1) << elapsedSeconds << "s";
-  clockText_.setString(oss.str());
+  const long long tenths = std::llround(static_cast<double>(elapsedSeconds) * 10.0);
+  if (tenths != displayedTenths_) {
+    refreshClock(tenths);
+  }
 
-  checklistText_.setString(buildChecklist(order));
+  const unsigned filled = order.filled;
+  if (filled != displayedChecklist_) {
+    refreshChecklist(filled);
+  }
 
   if (!hasCustomHint_) {
-    if (interacting) {
-      hintText_.setString("1-4 to select • Enter to confirm");
-    } else {
-      hintText_.setString("E to interact");
+    const DefaultHint wanted = interacting ? DefaultHint::Select : DefaultHint::Interact;
+    if (wanted != displayedHint_) {
+      hintText_.setString(wanted == DefaultHint::Select ? selectHint_ : interactHint_);
+      displayedHint_ = wanted;
     }
   }
 }
 
 void HUD::draw(sf::RenderTarget& target) const {
   target.draw(clockText_);
-  target.draw(promptText_);
   target.draw(checklistText_);
   target.draw(hintText_);
 }
 
+void HUD::capture(RenderSnapshot& snapshot) const {
+  snapshot.add(clockText_);
+  snapshot.add(checklistText_);
+  snapshot.add(hintText_);
+}
+
+void HUD::drawFixedLabels(sf::RenderTarget& target) const {
+  target.draw(promptText_);
+}
+
+void HUD::captureFixedLabels(RenderSnapshot& snapshot) const {
+  snapshot.add(promptText_);
+}
+
+std::uint64_t HUD::fixedLabelsRevision() const {
+  return fixedLabelsRevision_;
+}
+
 void HUD::setPrompt(const std::string& prompt) {
   promptText_.setString(prompt);
+  fixedLabelsRevision_ = StaticLayer::newRevision();
 }
 
 void HUD::setHint(const std::string& hint) {
-  hintText_.setString(hint);
+  hintText_.setString(sf::String::fromUtf8(hint.begin(), hint.end()));
   hasCustomHint_ = true;
+  displayedHint_ = DefaultHint::None;
 }
 
 void HUD::clearHint() {
   hasCustomHint_ = false;
   hintText_.setString("");
+  displayedHint_ = DefaultHint::None;
 }
 
-std::string HUD::buildChecklist(const Order& order) const {
-  auto check = [](bool value) -> std::string { return value ? "✅" : "⬜"; };
+void HUD::refreshClock(long long tenths) {
+  char buffer[32];
+  const int length = std::snprintf(buffer, sizeof(buffer), "Time: %lld.%llds", tenths / 10, tenths % 10);
+  if (length <= 0) {
+    return;
+  }
 
-  std::ostringstream oss;
-  oss << check(!order.drink.empty()) << " Drink\n"
-      << check(!order.size.empty()) << " Size\n"
-      << check(!order.milk.empty()) << " Milk\n"
-      << check(!order.customerName.empty()) << " Name";
-  return oss.str();
+  utils::assignAscii(scratch_, std::string_view(buffer, std::min(sizeof(buffer) - 1,
+                                                                  static_cast<std::size_t>(length))));
+  clockText_.setString(scratch_);
+  displayedTenths_ = tenths;
 }
 
+void HUD::refreshChecklist(unsigned filledMask) {
+  scratch_.clear();
+  for (unsigned field = 0; field < std::size(kChecklistLabels); ++field) {
+    const OrderFieldMask bit = orderFieldBit(static_cast<OrderField>(field));
+    scratch_ += sf::String((filledMask & bit) != 0 ? kChecked : kUnchecked);
+    for (const char* label = kChecklistLabels[field]; *label != '\0'; ++label) {
+      scratch_ += sf::String(static_cast<sf::Uint32>(*label));
+    }
+  }
+  checklistText_.setString(scratch_);
+  displayedChecklist_ = filledMask;
+}
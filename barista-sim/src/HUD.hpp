@@ -1,28 +1,56 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <string>
 
+#include "StaticLayer.hpp"
+
+class RenderSnapshot;
 class ResourceManager;
 struct Order;
 
+// Only touches text whose displayed value changed: the clock when its tenth
+// of a second ticks over, the checklist when an order field is filled in, the
+// hint when the interaction state flips. Labels are rebuilt into reused
+// sf::String buffers, so steady-state frames do no heap allocation and
+// sf::Text keeps its cached glyph geometry.
+//
+// The fixed labels (the controls prompt) are left out of draw() and
+// capture(): they sit above the counter, where nothing in the world is
+// drawn, so the scene composites them into its cached background layer.
 class HUD {
  public:
   void initialize(const ResourceManager& resources);
   void update(float elapsedSeconds, const Order& order, bool interacting);
   void draw(sf::RenderTarget& target) const;
+  void capture(RenderSnapshot& snapshot) const;
+  void drawFixedLabels(sf::RenderTarget& target) const;
+  void captureFixedLabels(RenderSnapshot& snapshot) const;
+  // A new StaticLayer revision whenever the fixed labels change.
+  [[nodiscard]] std::uint64_t fixedLabelsRevision() const;
 
   void setPrompt(const std::string& prompt);
   void setHint(const std::string& hint);
   void clearHint();
 
  private:
-  std::string buildChecklist(const Order& order) const;
+  enum class DefaultHint { None, Interact, Select };
+
+  void refreshClock(long long tenths);
+  void refreshChecklist(unsigned filledMask);
 
   sf::Text clockText_;
   sf::Text promptText_;
   sf::Text checklistText_;
   sf::Text hintText_;
+  std::uint64_t fixedLabelsRevision_{StaticLayer::newRevision()};
   bool hasCustomHint_{false};
-};
 
+  sf::String scratch_;
+  sf::String interactHint_;
+  sf::String selectHint_;
+  long long displayedTenths_{-1};
+  unsigned displayedChecklist_{~0U};
+  DefaultHint displayedHint_{DefaultHint::None};
+};
@@ -0,0 +1,179 @@
+#include "HeadlessRunner.hpp"
+
+#include <utility>
+
+#include "AssetLoader.hpp"
+#include "CafeScene.hpp"
+#include "InputRecording.hpp"
+#include "InputScript.hpp"
+#include "Resources.hpp"
+
+HeadlessAssets::HeadlessAssets(const std::string& scenarioPath)
+    : dialogue_(scenarioPath.empty() ? DialogueGraph::builtin()
+                                     : DialogueGraph::loadScenario(scenarioPath)) {
+  resources_.setGraphicsEnabled(false);
+  loadDefaultAssets(resources_, false);
+  // A few thousand cells; not worth waking workers for.
+  JobSystem jobs(0);
+  layout_ = CafeLayout::build(resources_, jobs);
+}
+
+const ResourceManager& HeadlessAssets::resources() const {
+  return resources_;
+}
+
+const DialogueGraph& HeadlessAssets::dialogue() const {
+  return dialogue_;
+}
+
+const std::shared_ptr<const CafeLayout>& HeadlessAssets::layout() const {
+  return layout_;
+}
+
+HeadlessRunner::HeadlessRunner(const HeadlessAssets& assets, HeadlessConfig config)
+    : assets_(assets), config_(config), jobs_(config.workerThreads) {
+  audio_.setEnabled(false);
+  audio_.setResources(&assets_.resources());
+}
+
+HeadlessRunner::~HeadlessRunner() = default;
+
+std::optional<OrderReport> HeadlessRunner::runSession(const InputScript& script) {
+  begin(script);
+  while (step()) {
+  }
+  return finish();
+}
+
+std::optional<OrderReport> HeadlessRunner::replaySession(const InputRecording& recording) {
+  begin(recording);
+  while (step()) {
+  }
+  return finish();
+}
+
+void HeadlessRunner::begin(const InputScript& script) {
+  start(script, config_.seed, kFixedTimeStep, config_.customerCount, {});
+}
+
+void HeadlessRunner::begin(const InputRecording& recording) {
+  start(recording.script(), recording.seed(), recording.timeStep(), recording.customerCount(),
+        recording.heldKeys());
+}
+
+void HeadlessRunner::start(const InputScript& script, std::uint64_t seed, float timeStep,
+                           std::size_t customerCount,
+                           std::span<const sf::Keyboard::Key> heldKeys) {
+  finish();
+  finished_ = false;
+  input_ = InputManager{};
+  for (const sf::Keyboard::Key key : heldKeys) {
+    sf::Event press{};
+    press.type = sf::Event::KeyPressed;
+    press.key.code = key;
+    input_.handleEvent(press);
+  }
+  script_ = &script;
+  timeStep_ = timeStep;
+  tick_ = 0;
+  nextStep_ = 0;
+  const auto graceTicks = static_cast<std::uint32_t>(config_.idleGraceSeconds / timeStep);
+  lastTick_ = script.lengthTicks() + graceTicks;
+
+  scene_ = std::make_unique<CafeScene>(
+      *this, SceneContext{nullptr, assets_.resources(), audio_, input_, jobs_},
+      assets_.dialogue(), customerCount, seed, assets_.layout());
+  scene_->onEnter();
+}
+
+bool HeadlessRunner::step() {
+  if (!scene_ || finished_ || tick_ >= lastTick_) {
+    return false;
+  }
+
+  const auto& steps = script_->steps();
+  input_.beginFrame();
+  for (; nextStep_ < steps.size() && steps[nextStep_].tick <= tick_ && !finished_; ++nextStep_) {
+    input_.handleEvent(steps[nextStep_].event);
+    scene_->handleEvent(steps[nextStep_].event);
+  }
+  if (finished_) {
+    return false;
+  }
+
+  scene_->update(timeStep_);
+  input_.endFrame();
+  ++tick_;
+  return !finished_ && tick_ < lastTick_;
+}
+
+std::optional<OrderReport> HeadlessRunner::finish() {
+  if (scene_) {
+    scene_->onExit();
+    scene_.reset();
+  }
+  script_ = nullptr;
+  return std::exchange(report_, std::nullopt);
+}
+
+void HeadlessRunner::showReport(const OrderReport& report) {
+  report_ = report;
+  finished_ = true;
+}
+
+void HeadlessRunner::restartSimulation() {
+  finished_ = true;
+}
+
+void HeadlessRunner::requestQuit() {
+  finished_ = true;
+}
+
+std::size_t runHeadlessSessions(const InputScript& script, std::size_t sessions,
+                                HeadlessConfig config, const ReportSink& sink) {
+  const HeadlessAssets assets(config.scenarioPath);
+  HeadlessRunner runner(assets, config);
+  std::size_t reported = 0;
+  for (std::size_t i = 0; i < sessions; ++i) {
+    if (const auto report = runner.runSession(script)) {
+      sink(*report);
+      ++reported;
+    }
+  }
+  return reported;
+}
+
+std::size_t runHeadlessReplays(const std::vector<InputRecording>& recordings,
+                               std::size_t sessions, HeadlessConfig config,
+                               const ReportSink& sink) {
+  const HeadlessAssets assets(config.scenarioPath);
+  HeadlessRunner runner(assets, config);
+  std::size_t reported = 0;
+  for (const InputRecording& recording : recordings) {
+    for (std::size_t i = 0; i < sessions; ++i) {
+      if (const auto report = runner.replaySession(recording)) {
+        sink(*report);
+        ++reported;
+      }
+    }
+  }
+  return reported;
+}
+
+std::vector<OrderReport> runHeadlessSessions(const InputScript& script, std::size_t sessions,
+                                             HeadlessConfig config) {
+  std::vector<OrderReport> reports;
+  reports.reserve(sessions);
+  runHeadlessSessions(script, sessions, std::move(config),
+                      [&reports](const OrderReport& report) { reports.push_back(report); });
+  return reports;
+}
+
+std::vector<OrderReport> runHeadlessReplays(const std::vector<InputRecording>& recordings,
+                                            std::size_t sessions, HeadlessConfig config) {
+  std::vector<OrderReport> reports;
+  reports.reserve(recordings.size() * sessions);
+  runHeadlessReplays(recordings, sessions, std::move(config),
+                     [&reports](const OrderReport& report) { reports.push_back(report); });
+  return reports;
+}
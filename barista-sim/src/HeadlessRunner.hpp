@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Audio.hpp"
+#include "DialogueGraph.hpp"
+#include "Input.hpp"
+#include "JobSystem.hpp"
+#include "ReportScene.hpp"
+#include "Resources.hpp"
+#include "Scene.hpp"
+
+class CafeLayout;
+class CafeScene;
+class InputRecording;
+class InputScript;
+
+struct HeadlessConfig {
+  // Simulated time allowed after the last scripted event before a session
+  // that never reached the report is abandoned.
+  float idleGraceSeconds{10.0f};
+  std::size_t customerCount{kDefaultCustomerCount};
+  unsigned workerThreads{JobSystem::kAutomatic};
+  // Scenario JSON for the barista; empty runs the built-in order. Read by
+  // the run functions below when they load HeadlessAssets.
+  std::string scenarioPath;
+  // Seeds every scripted session's CafeScene, so repeated runs match.
+  // Replays use the recording's seed instead.
+  std::uint64_t seed{1};
+};
+
+// Everything headless sessions only read: assets/ loaded with graphics
+// disabled, the scenario and the café layout. Load once and share between
+// any number of runners, on any threads.
+class HeadlessAssets {
+ public:
+  // scenarioPath empty runs the built-in order. Throws when anything fails
+  // to load.
+  explicit HeadlessAssets(const std::string& scenarioPath = {});
+
+  HeadlessAssets(const HeadlessAssets&) = delete;
+  HeadlessAssets& operator=(const HeadlessAssets&) = delete;
+
+  [[nodiscard]] const ResourceManager& resources() const;
+  [[nodiscard]] const DialogueGraph& dialogue() const;
+  [[nodiscard]] const std::shared_ptr<const CafeLayout>& layout() const;
+
+ private:
+  ResourceManager resources_;
+  DialogueGraph dialogue_;
+  std::shared_ptr<const CafeLayout> layout_;
+};
+
+// Drives CafeScene without a window: ticks update() at kFixedTimeStep as fast
+// as the CPU allows, feeds scripted events and never draws. Everything a
+// session changes belongs to the runner, so runners sharing assets can run
+// on separate threads. assets must outlive the runner.
+class HeadlessRunner : public SceneHost {
+ public:
+  explicit HeadlessRunner(const HeadlessAssets& assets, HeadlessConfig config = {});
+  ~HeadlessRunner() override;
+
+  // Returns the report the scene produced, or nothing if the script quit or
+  // timed out first.
+  std::optional<OrderReport> runSession(const InputScript& script);
+  // Plays a recorded session back with its seed, tick length and crowd
+  // size. The scenario must be the one it was recorded with.
+  std::optional<OrderReport> replaySession(const InputRecording& recording);
+
+  // The same sessions a tick at a time, e.g. to keep several runners in
+  // step: begin() starts one (the script or recording must outlive it),
+  // step() runs a tick and returns false once the session has ended, and
+  // finish() returns its report.
+  void begin(const InputScript& script);
+  void begin(const InputRecording& recording);
+  bool step();
+  std::optional<OrderReport> finish();
+
+  void showReport(const OrderReport& report) override;
+  void restartSimulation() override;
+  void requestQuit() override;
+
+ private:
+  // heldKeys start down, as if pressed before the session.
+  void start(const InputScript& script, std::uint64_t seed, float timeStep,
+             std::size_t customerCount, std::span<const sf::Keyboard::Key> heldKeys);
+
+  const HeadlessAssets& assets_;
+  HeadlessConfig config_;
+  AudioManager audio_;
+  InputManager input_;
+  JobSystem jobs_;
+
+  std::unique_ptr<CafeScene> scene_;
+  const InputScript* script_{nullptr};
+  float timeStep_{kFixedTimeStep};
+  std::uint32_t tick_{0};
+  std::uint32_t lastTick_{0};
+  std::size_t nextStep_{0};
+  std::optional<OrderReport> report_;
+  bool finished_{false};
+};
+
+// Receives each report as its session ends, e.g. to feed SessionAnalytics
+// without keeping the reports.
+using ReportSink = std::function<void(const OrderReport&)>;
+
+// Loads the shared headless resources from assets/ and runs the script
+// `sessions` times, returning every report produced.
+std::vector<OrderReport> runHeadlessSessions(const InputScript& script, std::size_t sessions,
+                                             HeadlessConfig config = {});
+// Like runHeadlessSessions, replaying every recording `sessions` times.
+std::vector<OrderReport> runHeadlessReplays(const std::vector<InputRecording>& recordings,
+                                            std::size_t sessions, HeadlessConfig config = {});
+// Streaming forms of the above: reports go to sink instead of a vector.
+// Return the number of sessions that reported.
+std::size_t runHeadlessSessions(const InputScript& script, std::size_t sessions,
+                                HeadlessConfig config, const ReportSink& sink);
+std::size_t runHeadlessReplays(const std::vector<InputRecording>& recordings,
+                               std::size_t sessions, HeadlessConfig config,
+                               const ReportSink& sink);
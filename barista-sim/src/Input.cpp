@@ -77,6 +77,16 @@ bool InputManager::isKeyReleased(sf::Keyboard::Key key) const {
   return !current_.at(key) && previous_.at(key);
 }
 
+std::vector<sf::Keyboard::Key> InputManager::heldKeys() const {
+  std::vector<sf::Keyboard::Key> keys;
+  for (std::size_t key = 0; key < current_.size(); ++key) {
+    if (current_[key]) {
+      keys.push_back(static_cast<sf::Keyboard::Key>(key));
+    }
+  }
+  return keys;
+}
+
 const std::u32string& InputManager::textBuffer() const {
   return textBuffer_;
 }
@@ -3,6 +3,7 @@
 #include <SFML/Window/Event.hpp>
 #include <SFML/Window/Keyboard.hpp>
 #include <array>
+#include <vector>
 
 class InputManager {
  public:
@@ -15,6 +16,8 @@ class InputManager {
   [[nodiscard]] bool isKeyDown(sf::Keyboard::Key key) const;
   [[nodiscard]] bool isKeyPressed(sf::Keyboard::Key key) const;
   [[nodiscard]] bool isKeyReleased(sf::Keyboard::Key key) const;
+  // Keys currently down, in key order.
+  [[nodiscard]] std::vector<sf::Keyboard::Key> heldKeys() const;
 
   [[nodiscard]] const std::u32string& textBuffer() const;
   void clearTextBuffer();
@@ -0,0 +1,247 @@
+#include "InputRecording.hpp"
+
+#include <SFML/Window/Keyboard.hpp>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+constexpr char kMagic[4] = {'B', 'S', 'R', 'C'};
+constexpr std::uint64_t kVersion = 2;
+// Before the held keys were stored.
+constexpr std::uint64_t kVersionWithoutHeldKeys = 1;
+
+enum EventKind : std::uint64_t { kKeyPressed = 0, kKeyReleased = 1, kTextEntered = 2 };
+
+void writeVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<std::uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<std::uint8_t>(value));
+}
+
+class Reader {
+ public:
+  Reader(std::span<const std::uint8_t> bytes, const std::string& sourceName)
+      : bytes_(bytes), sourceName_(sourceName) {}
+
+  std::uint64_t varint() {
+    std::uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (pos_ >= bytes_.size()) {
+        fail("truncated");
+      }
+      const std::uint8_t byte = bytes_[pos_++];
+      value |= std::uint64_t{byte & 0x7Fu} << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    fail("malformed number");
+  }
+
+  // A varint that must fit in 32 bits.
+  std::uint32_t varint32() {
+    const std::uint64_t value = varint();
+    if (value > ~std::uint32_t{0}) {
+      fail("number out of range");
+    }
+    return static_cast<std::uint32_t>(value);
+  }
+
+  [[nodiscard]] bool done() const {
+    return pos_ == bytes_.size();
+  }
+
+  [[noreturn]] void fail(const std::string& message) const {
+    throw std::runtime_error(sourceName_ + ": " + message + " at byte " + std::to_string(pos_));
+  }
+
+ private:
+  std::span<const std::uint8_t> bytes_;
+  const std::string& sourceName_;
+  std::size_t pos_{0};
+};
+}  // namespace
+
+InputRecording InputRecording::loadFromFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Failed to open recording: " + path);
+  }
+  const std::vector<std::uint8_t> bytes{std::istreambuf_iterator<char>(in),
+                                        std::istreambuf_iterator<char>()};
+  return decode(bytes, path);
+}
+
+InputRecording InputRecording::decode(std::span<const std::uint8_t> bytes,
+                                      const std::string& sourceName) {
+  if (bytes.size() < sizeof(kMagic) || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error(sourceName + ": not an input recording");
+  }
+  Reader reader(bytes.subspan(sizeof(kMagic)), sourceName);
+  const std::uint64_t version = reader.varint();
+  if (version != kVersion && version != kVersionWithoutHeldKeys) {
+    reader.fail("unsupported recording version");
+  }
+
+  InputRecording recording;
+  recording.seed_ = reader.varint();
+  recording.customerCount_ = reader.varint32();
+  recording.timeStep_ = std::bit_cast<float>(reader.varint32());
+  if (!(recording.timeStep_ > 0.0f)) {
+    reader.fail("bad tick length");
+  }
+  const std::uint32_t lengthTicks = reader.varint32();
+  if (version >= kVersion) {
+    for (std::uint32_t count = reader.varint32(); count > 0; --count) {
+      const std::uint32_t key = reader.varint32();
+      if (key >= sf::Keyboard::KeyCount) {
+        reader.fail("unknown key");
+      }
+      recording.heldKeys_.push_back(static_cast<sf::Keyboard::Key>(key));
+    }
+  }
+
+  std::vector<InputScript::Step> steps;
+  std::uint32_t tick = 0;
+  while (!reader.done()) {
+    const std::uint32_t delta = reader.varint32();
+    // tick stays below lengthTicks, so this cannot wrap.
+    if (delta >= lengthTicks - tick) {
+      reader.fail("input past the end of the session");
+    }
+    tick += delta;
+    for (std::uint32_t count = reader.varint32(); count > 0; --count) {
+      const std::uint64_t code = reader.varint();
+      sf::Event event{};
+      switch (code & 3) {
+        case kKeyPressed:
+        case kKeyReleased:
+          if ((code >> 2) >= sf::Keyboard::KeyCount) {
+            reader.fail("unknown key");
+          }
+          event.type = (code & 3) == kKeyPressed ? sf::Event::KeyPressed : sf::Event::KeyReleased;
+          event.key.code = static_cast<sf::Keyboard::Key>(code >> 2);
+          break;
+        case kTextEntered:
+          event.type = sf::Event::TextEntered;
+          event.text.unicode = static_cast<sf::Uint32>(code >> 2);
+          break;
+        default:
+          reader.fail("unknown event");
+      }
+      steps.push_back({tick, event});
+    }
+  }
+  recording.script_ = InputScript::fromSteps(std::move(steps), lengthTicks);
+  return recording;
+}
+
+std::uint64_t InputRecording::seed() const {
+  return seed_;
+}
+
+float InputRecording::timeStep() const {
+  return timeStep_;
+}
+
+std::size_t InputRecording::customerCount() const {
+  return customerCount_;
+}
+
+std::span<const sf::Keyboard::Key> InputRecording::heldKeys() const {
+  return heldKeys_;
+}
+
+const InputScript& InputRecording::script() const {
+  return script_;
+}
+
+void InputRecorder::begin(std::uint64_t seed, float timeStep, std::size_t customerCount,
+                          std::span<const sf::Keyboard::Key> heldKeys) {
+  active_ = true;
+  seed_ = seed;
+  timeStep_ = timeStep;
+  customerCount_ = customerCount;
+  heldKeys_.assign(heldKeys.begin(), heldKeys.end());
+  tick_ = 0;
+  lastEntryTick_ = 0;
+  body_.clear();
+  tickEvents_.clear();
+  tickEventCount_ = 0;
+}
+
+void InputRecorder::record(const sf::Event& event) {
+  if (!active_) {
+    return;
+  }
+  // Everything else (focus, mouse, resize) never reaches the simulation.
+  switch (event.type) {
+    case sf::Event::KeyPressed:
+    case sf::Event::KeyReleased:
+      if (event.key.code < 0 || event.key.code >= sf::Keyboard::KeyCount) {
+        return;
+      }
+      writeVarint(tickEvents_, static_cast<std::uint64_t>(event.key.code) << 2 |
+                                   (event.type == sf::Event::KeyPressed ? kKeyPressed : kKeyReleased));
+      break;
+    case sf::Event::TextEntered:
+      writeVarint(tickEvents_, std::uint64_t{event.text.unicode} << 2 | kTextEntered);
+      break;
+    default:
+      return;
+  }
+  ++tickEventCount_;
+}
+
+void InputRecorder::endTick() {
+  if (!active_) {
+    return;
+  }
+  flushTick();
+  ++tick_;
+}
+
+std::vector<std::uint8_t> InputRecorder::finish() {
+  std::vector<std::uint8_t> bytes;
+  if (!active_) {
+    return bytes;
+  }
+  flushTick();
+  active_ = false;
+
+  bytes.reserve(32 + body_.size());
+  bytes.insert(bytes.end(), std::begin(kMagic), std::end(kMagic));
+  writeVarint(bytes, kVersion);
+  writeVarint(bytes, seed_);
+  writeVarint(bytes, customerCount_);
+  writeVarint(bytes, std::bit_cast<std::uint32_t>(timeStep_));
+  writeVarint(bytes, std::uint64_t{tick_} + 1);
+  writeVarint(bytes, heldKeys_.size());
+  for (const sf::Keyboard::Key key : heldKeys_) {
+    writeVarint(bytes, static_cast<std::uint64_t>(key));
+  }
+  bytes.insert(bytes.end(), body_.begin(), body_.end());
+  return bytes;
+}
+
+bool InputRecorder::active() const {
+  return active_;
+}
+
+void InputRecorder::flushTick() {
+  if (tickEventCount_ == 0) {
+    return;
+  }
+  writeVarint(body_, tick_ - lastEntryTick_);
+  writeVarint(body_, tickEventCount_);
+  body_.insert(body_.end(), tickEvents_.begin(), tickEvents_.end());
+  lastEntryTick_ = tick_;
+  tickEvents_.clear();
+  tickEventCount_ = 0;
+}
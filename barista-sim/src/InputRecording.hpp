@@ -0,0 +1,84 @@
+#pragma once
+
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "InputScript.hpp"
+
+// Binary log of one CafeScene session's input: the events dispatched before
+// each fixed tick, plus the seed, tick length and crowd size the session ran
+// with, so HeadlessRunner::replaySession reproduces it tick for tick. Key
+// state is rebuilt from the press and release events, as InputManager does,
+// starting from the keys already held when the session began (a key held
+// through a restart keeps moving the player).
+//
+// Every integer is an unsigned LEB128 varint:
+//   "BSRC" version seed customerCount timeStepBits lengthTicks
+//   heldKeyCount key...
+//   then, for each tick that had input:
+//     ticksSincePreviousEntry eventCount event...
+//   where an event is key << 2 | 0 (pressed), key << 2 | 1 (released) or
+//   codepoint << 2 | 2 (text entered).
+// Ticks without input cost nothing, and a tick with a key tap costs three or
+// four bytes. Version 1 files, which lack the held keys, still load.
+class InputRecording {
+ public:
+  static InputRecording loadFromFile(const std::string& path);
+  // Throws std::runtime_error naming sourceName when the data is not a
+  // recording this build can read.
+  static InputRecording decode(std::span<const std::uint8_t> bytes,
+                               const std::string& sourceName = "<recording>");
+
+  [[nodiscard]] std::uint64_t seed() const;
+  [[nodiscard]] float timeStep() const;
+  [[nodiscard]] std::size_t customerCount() const;
+  // Keys down before the first tick. They set the input state only; the
+  // scene never saw them pressed.
+  [[nodiscard]] std::span<const sf::Keyboard::Key> heldKeys() const;
+  // The events with their tick numbers, ready for HeadlessRunner.
+  [[nodiscard]] const InputScript& script() const;
+
+ private:
+  std::uint64_t seed_{0};
+  float timeStep_{0.0f};
+  std::size_t customerCount_{0};
+  std::vector<sf::Keyboard::Key> heldKeys_;
+  InputScript script_;
+};
+
+// Encodes a session as App runs it. Call record() for every event dispatched
+// to the scene, in dispatch order, and endTick() after every scene update.
+class InputRecorder {
+ public:
+  // Starts a new session, dropping any unfinished one. heldKeys are the keys
+  // already down as it starts (InputManager::heldKeys()).
+  void begin(std::uint64_t seed, float timeStep, std::size_t customerCount,
+             std::span<const sf::Keyboard::Key> heldKeys);
+  void record(const sf::Event& event);
+  void endTick();
+  // Returns the encoded session, counting the tick in progress, and stops
+  // recording until the next begin().
+  [[nodiscard]] std::vector<std::uint8_t> finish();
+
+  [[nodiscard]] bool active() const;
+
+ private:
+  void flushTick();
+
+  bool active_{false};
+  std::uint64_t seed_{0};
+  float timeStep_{0.0f};
+  std::size_t customerCount_{0};
+  std::vector<sf::Keyboard::Key> heldKeys_;
+  std::uint32_t tick_{0};
+  std::uint32_t lastEntryTick_{0};
+  std::vector<std::uint8_t> body_;
+  // Events of the tick in progress, already encoded.
+  std::vector<std::uint8_t> tickEvents_;
+  std::uint32_t tickEventCount_{0};
+};
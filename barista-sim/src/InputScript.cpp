@@ -0,0 +1,166 @@
+#include "InputScript.hpp"
+
+#include <SFML/Window/Keyboard.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "Scene.hpp"
+
+namespace {
+struct NamedKey {
+  const char* name;
+  sf::Keyboard::Key key;
+};
+
+constexpr NamedKey kNamedKeys[] = {
+    {"Enter", sf::Keyboard::Enter},   {"Return", sf::Keyboard::Enter},
+    {"Escape", sf::Keyboard::Escape}, {"Esc", sf::Keyboard::Escape},
+    {"Space", sf::Keyboard::Space},   {"Backspace", sf::Keyboard::Backspace},
+    {"Tab", sf::Keyboard::Tab},       {"LShift", sf::Keyboard::LShift},
+    {"RShift", sf::Keyboard::RShift}, {"Left", sf::Keyboard::Left},
+    {"Right", sf::Keyboard::Right},   {"Up", sf::Keyboard::Up},
+    {"Down", sf::Keyboard::Down},
+};
+
+[[nodiscard]] bool parseKey(const std::string& name, sf::Keyboard::Key& key) {
+  if (name.size() == 1 && name[0] >= 'A' && name[0] <= 'Z') {
+    key = static_cast<sf::Keyboard::Key>(sf::Keyboard::A + (name[0] - 'A'));
+    return true;
+  }
+  if (name.size() == 1 && name[0] >= '0' && name[0] <= '9') {
+    key = static_cast<sf::Keyboard::Key>(sf::Keyboard::Num0 + (name[0] - '0'));
+    return true;
+  }
+  if (name.size() == 4 && name.compare(0, 3, "Num") == 0 && name[3] >= '0' && name[3] <= '9') {
+    key = static_cast<sf::Keyboard::Key>(sf::Keyboard::Num0 + (name[3] - '0'));
+    return true;
+  }
+  for (const auto& named : kNamedKeys) {
+    if (name == named.name) {
+      key = named.key;
+      return true;
+    }
+  }
+  return false;
+}
+
+[[nodiscard]] sf::Event makeKeyEvent(sf::Event::EventType type, sf::Keyboard::Key key) {
+  sf::Event event{};
+  event.type = type;
+  event.key.code = key;
+  return event;
+}
+
+[[nodiscard]] sf::Event makeTextEvent(char character) {
+  sf::Event event{};
+  event.type = sf::Event::TextEntered;
+  event.text.unicode = static_cast<unsigned char>(character);
+  return event;
+}
+
+[[nodiscard]] std::uint32_t secondsToTicks(float seconds) {
+  return static_cast<std::uint32_t>(std::lround(std::max(0.0f, seconds) / kFixedTimeStep));
+}
+}  // namespace
+
+InputScript InputScript::loadFromFile(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Failed to open input script: " + path);
+  }
+  return parse(file, path);
+}
+
+InputScript InputScript::parse(std::istream& in, const std::string& sourceName) {
+  InputScript script;
+  std::uint32_t cursor = 0;
+  std::string line;
+  unsigned lineNumber = 0;
+
+  auto fail = [&](const std::string& message) {
+    throw std::runtime_error(sourceName + ":" + std::to_string(lineNumber) + ": " + message);
+  };
+  auto readKey = [&](std::istringstream& args) {
+    std::string name;
+    sf::Keyboard::Key key{};
+    if (!(args >> name) || !parseKey(name, key)) {
+      fail("unknown key '" + name + "'");
+    }
+    return key;
+  };
+  auto readSeconds = [&](std::istringstream& args) {
+    float seconds = 0.0f;
+    if (!(args >> seconds) || seconds < 0.0f) {
+      fail("expected a non-negative duration in seconds");
+    }
+    return seconds;
+  };
+  auto push = [&](std::uint32_t tick, const sf::Event& event) {
+    script.steps_.push_back(Step{tick, event});
+  };
+
+  while (std::getline(in, line)) {
+    ++lineNumber;
+    if (const auto comment = line.find('#'); comment != std::string::npos) {
+      line.erase(comment);
+    }
+
+    std::istringstream args(line);
+    std::string command;
+    if (!(args >> command)) {
+      continue;
+    }
+
+    if (command == "wait") {
+      cursor += secondsToTicks(readSeconds(args));
+    } else if (command == "press") {
+      push(cursor, makeKeyEvent(sf::Event::KeyPressed, readKey(args)));
+    } else if (command == "release") {
+      push(cursor, makeKeyEvent(sf::Event::KeyReleased, readKey(args)));
+    } else if (command == "tap") {
+      const auto key = readKey(args);
+      push(cursor, makeKeyEvent(sf::Event::KeyPressed, key));
+      cursor += 1;
+      push(cursor, makeKeyEvent(sf::Event::KeyReleased, key));
+    } else if (command == "hold") {
+      const auto key = readKey(args);
+      const float seconds = readSeconds(args);
+      push(cursor, makeKeyEvent(sf::Event::KeyPressed, key));
+      cursor += std::max<std::uint32_t>(1, secondsToTicks(seconds));
+      push(cursor, makeKeyEvent(sf::Event::KeyReleased, key));
+    } else if (command == "type") {
+      std::string text;
+      std::getline(args >> std::ws, text);
+      while (!text.empty() && (text.back() == ' ' || text.back() == '\r')) {
+        text.pop_back();
+      }
+      for (const char character : text) {
+        push(cursor, makeTextEvent(character));
+      }
+    } else {
+      fail("unknown command '" + command + "'");
+    }
+  }
+
+  script.lengthTicks_ = cursor + 1;
+  return script;
+}
+
+InputScript InputScript::fromSteps(std::vector<Step> steps, std::uint32_t lengthTicks) {
+  InputScript script;
+  script.steps_ = std::move(steps);
+  script.lengthTicks_ = lengthTicks;
+  return script;
+}
+
+const std::vector<InputScript::Step>& InputScript::steps() const {
+  return steps_;
+}
+
+std::uint32_t InputScript::lengthTicks() const {
+  return lengthTicks_;
+}
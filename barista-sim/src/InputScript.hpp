@@ -0,0 +1,38 @@
+#pragma once
+
+#include <SFML/Window/Event.hpp>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+// A timeline of synthetic window events used to drive scenes without a window.
+//
+// Text format, one command per line ('#' starts a comment):
+//   wait <seconds>          advance the cursor
+//   press <key>             key down
+//   release <key>           key up
+//   tap <key>               press now, release on the next tick
+//   hold <key> <seconds>    press, wait, release
+//   type <text>             TextEntered events for every character
+// Keys use SFML names: A-Z, Num0-Num9 (or 0-9), Enter, Escape, Space,
+// Backspace, Tab, LShift, RShift, Left, Right, Up, Down.
+class InputScript {
+ public:
+  struct Step {
+    std::uint32_t tick{0};
+    sf::Event event{};
+  };
+
+  static InputScript loadFromFile(const std::string& path);
+  static InputScript parse(std::istream& in, const std::string& sourceName = "<script>");
+  // steps must be sorted by tick, all before lengthTicks.
+  static InputScript fromSteps(std::vector<Step> steps, std::uint32_t lengthTicks);
+
+  [[nodiscard]] const std::vector<Step>& steps() const;
+  [[nodiscard]] std::uint32_t lengthTicks() const;
+
+ private:
+  std::vector<Step> steps_;
+  std::uint32_t lengthTicks_{0};
+};
@@ -0,0 +1,172 @@
+#include "JobSystem.hpp"
+
+namespace {
+// Which JobSystem, if any, the current thread works for, and its queue.
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local std::size_t currentQueue = 0;
+
+constexpr std::size_t kInitialQueueCapacity = 64;
+}  // namespace
+
+bool JobCounter::done() const {
+  return pending_.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem(unsigned workerCount) {
+  if (workerCount == kAutomatic) {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    workerCount = hardware > 1 ? hardware - 1 : 0;
+  }
+  queues_.reserve(workerCount + 1);
+  for (unsigned i = 0; i <= workerCount; ++i) {
+    queues_.push_back(std::make_unique<WorkQueue>());
+    queues_.back()->ring.resize(kInitialQueueCapacity);
+  }
+  workers_.reserve(workerCount);
+  for (unsigned i = 0; i < workerCount; ++i) {
+    workers_.emplace_back(&JobSystem::workerLoop, this, i);
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+unsigned JobSystem::workerCount() const {
+  return static_cast<unsigned>(workers_.size());
+}
+
+void JobSystem::wait(JobCounter& counter) {
+  const std::size_t home = homeQueue();
+  while (!counter.done()) {
+    if (!runOne(home)) {
+      std::this_thread::yield();
+    }
+  }
+  // finish() decrements under this lock; taking it here means the job that
+  // finished the counter has let go of it too.
+  std::lock_guard<std::mutex> lock(counter.mutex_);
+}
+
+void JobSystem::WorkQueue::push(const Job& job) {
+  if (size == ring.size()) {
+    // Unroll into a ring twice the size, oldest job first.
+    std::vector<Job> grown(std::max<std::size_t>(ring.size() * 2, kInitialQueueCapacity));
+    for (std::size_t i = 0; i < size; ++i) {
+      grown[i] = ring[(head + i) % ring.size()];
+    }
+    ring.swap(grown);
+    head = 0;
+  }
+  ring[(head + size) % ring.size()] = job;
+  ++size;
+}
+
+bool JobSystem::WorkQueue::popBack(Job& job) {
+  if (size == 0) {
+    return false;
+  }
+  --size;
+  job = ring[(head + size) % ring.size()];
+  return true;
+}
+
+bool JobSystem::WorkQueue::popFront(Job& job) {
+  if (size == 0) {
+    return false;
+  }
+  job = ring[head];
+  head = (head + 1) % ring.size();
+  --size;
+  return true;
+}
+
+void JobSystem::schedule(const Job& job, const JobCounter* after) {
+  if (after != nullptr) {
+    std::lock_guard<std::mutex> lock(after->mutex_);
+    if (!after->done()) {
+      after->waiting_.push_back(job);
+      return;
+    }
+  }
+  enqueue(job);
+}
+
+void JobSystem::enqueue(const Job& job) {
+  {
+    // Counting under the sleep lock keeps a worker from missing the wake-up
+    // between checking queued_ and going to sleep. Counting before the push
+    // keeps queued_ from dropping below the number of queued jobs.
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    queued_.fetch_add(1, std::memory_order_relaxed);
+  }
+  WorkQueue& queue = *queues_[homeQueue()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.push(job);
+  }
+  wake_.notify_one();
+}
+
+bool JobSystem::runOne(std::size_t home) {
+  Job job{};
+  bool found = false;
+  {
+    WorkQueue& own = *queues_[home];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    found = own.popBack(job);
+  }
+  for (std::size_t offset = 1; !found && offset < queues_.size(); ++offset) {
+    WorkQueue& victim = *queues_[(home + offset) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    found = victim.popFront(job);
+  }
+  if (!found) {
+    return false;
+  }
+  queued_.fetch_sub(1, std::memory_order_relaxed);
+  execute(job);
+  return true;
+}
+
+void JobSystem::execute(const Job& job) {
+  job.run(job.context, job.begin, job.end);
+  finish(*job.counter);
+}
+
+void JobSystem::finish(JobCounter& counter) {
+  std::lock_guard<std::mutex> lock(counter.mutex_);
+  if (counter.pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  for (const Job& released : counter.waiting_) {
+    enqueue(released);
+  }
+  counter.waiting_.clear();
+}
+
+void JobSystem::workerLoop(std::size_t index) {
+  currentSystem = this;
+  currentQueue = index;
+  while (true) {
+    if (runOne(index)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wake_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_relaxed) > 0; });
+    if (stopping_) {
+      return;
+    }
+  }
+}
+
+std::size_t JobSystem::homeQueue() const {
+  return currentSystem == this ? currentQueue : queues_.size() - 1;
+}
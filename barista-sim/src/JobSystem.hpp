@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobCounter;
+
+// Small fork-join scheduler for the simulation: a fixed set of worker
+// threads, each with its own queue. A thread takes its newest job from its
+// own queue and, when that is empty, steals the oldest job from another, so
+// work spreads without a shared queue everyone contends on. Threads waiting
+// on a batch run queued jobs instead of blocking.
+//
+// Jobs are a function pointer plus a context pointer, so submitting never
+// allocates once the queues have grown. Jobs must not throw.
+class JobSystem {
+ public:
+  // One worker per hardware thread besides the caller.
+  static constexpr unsigned kAutomatic = ~0U;
+
+  struct Job {
+    void (*run)(const void* context, std::size_t begin, std::size_t end);
+    const void* context;
+    std::size_t begin;
+    std::size_t end;
+    JobCounter* counter;
+  };
+
+  // With no workers every job runs on the thread that waits for it.
+  explicit JobSystem(unsigned workerCount = kAutomatic);
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  [[nodiscard]] unsigned workerCount() const;
+
+  // Queues fn() under counter. With after, fn starts only once after is
+  // done, so submit after's own jobs first. fn is referenced, not copied:
+  // it must outlive the job.
+  template <typename Fn>
+  void submit(JobCounter& counter, const Fn& fn, const JobCounter* after = nullptr);
+  template <typename Fn>
+  void submit(JobCounter& counter, const Fn&& fn, const JobCounter* after = nullptr) = delete;
+
+  // Runs queued jobs on this thread until counter is done.
+  void wait(JobCounter& counter);
+
+  // Calls body(begin, end) over [0, count) in chunks of chunkSize and returns
+  // once every chunk has run. Chunk boundaries depend only on count and
+  // chunkSize, never on the number of threads, so a body that only writes
+  // its own range gives the same result however many workers there are.
+  // A single chunk runs inline.
+  template <typename Body>
+  void parallelFor(std::size_t count, std::size_t chunkSize, const Body& body);
+
+ private:
+  // Locked ring buffer. Its owner pushes and pops at the back; thieves take
+  // from the front, where the oldest (usually largest) work sits.
+  struct WorkQueue {
+    std::mutex mutex;
+    std::vector<Job> ring;
+    std::size_t head{0};
+    std::size_t size{0};
+
+    void push(const Job& job);
+    bool popBack(Job& job);
+    bool popFront(Job& job);
+  };
+
+  void schedule(const Job& job, const JobCounter* after);
+  void enqueue(const Job& job);
+  // Runs one job from queue home or, failing that, stolen from another.
+  bool runOne(std::size_t home);
+  void execute(const Job& job);
+  void finish(JobCounter& counter);
+  void workerLoop(std::size_t index);
+  // The calling thread's queue: its own for workers, the shared one last in
+  // queues_ for everyone else.
+  [[nodiscard]] std::size_t homeQueue() const;
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> queued_{0};
+  std::mutex sleepMutex_;
+  std::condition_variable wake_;
+  bool stopping_{false};
+};
+
+// Outstanding jobs of one batch. Only destroy a counter after wait() on it
+// has returned: the job that finishes it may still be releasing jobs that
+// were submitted to run after it.
+class JobCounter {
+ public:
+  JobCounter() = default;
+  JobCounter(const JobCounter&) = delete;
+  JobCounter& operator=(const JobCounter&) = delete;
+
+  [[nodiscard]] bool done() const;
+
+ private:
+  friend class JobSystem;
+
+  std::atomic<std::size_t> pending_{0};
+  // Submitting a job to run after a counter does not change what it counts.
+  mutable std::mutex mutex_;
+  // Jobs held back until this counter is done.
+  mutable std::vector<JobSystem::Job> waiting_;
+};
+
+template <typename Fn>
+void JobSystem::submit(JobCounter& counter, const Fn& fn, const JobCounter* after) {
+  counter.pending_.fetch_add(1, std::memory_order_relaxed);
+  schedule({[](const void* context, std::size_t, std::size_t) {
+              (*static_cast<const Fn*>(context))();
+            },
+            &fn, 0, 0, &counter},
+           after);
+}
+
+template <typename Body>
+void JobSystem::parallelFor(std::size_t count, std::size_t chunkSize, const Body& body) {
+  chunkSize = std::max<std::size_t>(chunkSize, 1);
+  if (count <= chunkSize || workers_.empty()) {
+    for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+      body(begin, std::min(count, begin + chunkSize));
+    }
+    return;
+  }
+
+  JobCounter counter;
+  counter.pending_.store((count + chunkSize - 1) / chunkSize, std::memory_order_relaxed);
+  for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+    enqueue({[](const void* context, std::size_t first, std::size_t last) {
+               (*static_cast<const Body*>(context))(first, last);
+             },
+             &body, begin, std::min(count, begin + chunkSize), &counter});
+  }
+  wait(counter);
+}
@@ -0,0 +1,420 @@
+#include "Json.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+// Deeper nesting is certainly not a scenario and would only risk the stack.
+constexpr std::size_t kMaxDepth = 64;
+
+void appendUtf8(std::string& out, std::uint32_t codepoint) {
+  if (codepoint < 0x80) {
+    out.push_back(static_cast<char>(codepoint));
+  } else if (codepoint < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+    out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+  } else if (codepoint < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+  }
+}
+
+// At least the number of values in text: each one is the root, the first
+// inside a '[' or '{', or follows a ','. Brackets and commas inside
+// strings are skipped.
+[[nodiscard]] std::size_t maxValueCount(std::string_view text) {
+  std::size_t count = 1;
+  bool inString = false;
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    const char c = text[i];
+    if (inString) {
+      if (c == '\\') {
+        ++i;
+      } else if (c == '"') {
+        inString = false;
+      }
+    } else if (c == '"') {
+      inString = true;
+    } else if (c == ',' || c == '[' || c == '{') {
+      ++count;
+    }
+  }
+  return count;
+}
+}  // namespace
+
+class JsonDocument::Parser {
+ public:
+  Parser(JsonDocument& document, std::string_view text, std::string_view sourceName)
+      : document_(document), text_(text), sourceName_(sourceName) {}
+
+  void run() {
+    skipWhitespace();
+    parseValue({}, 0);
+    skipWhitespace();
+    if (pos_ != text_.size()) {
+      fail("unexpected text after the document");
+    }
+  }
+
+ private:
+  void parseValue(std::string_view key, std::size_t depth) {
+    if (depth > kMaxDepth) {
+      fail("nesting too deep");
+    }
+    const auto index = static_cast<std::uint32_t>(document_.nodes_.size());
+    document_.nodes_.emplace_back();
+    document_.nodes_[index].key = key;
+
+    switch (peek()) {
+      case '{':
+        parseObject(index, depth);
+        break;
+      case '[':
+        parseArray(index, depth);
+        break;
+      case '"':
+        document_.nodes_[index].type = Type::String;
+        document_.nodes_[index].text = parseString();
+        break;
+      case 't':
+        expectWord("true");
+        document_.nodes_[index].type = Type::Bool;
+        document_.nodes_[index].boolean = true;
+        break;
+      case 'f':
+        expectWord("false");
+        document_.nodes_[index].type = Type::Bool;
+        break;
+      case 'n':
+        expectWord("null");
+        break;
+      default:
+        document_.nodes_[index].type = Type::Number;
+        document_.nodes_[index].number = parseNumber();
+        break;
+    }
+  }
+
+  void parseObject(std::uint32_t index, std::size_t depth) {
+    document_.nodes_[index].type = Type::Object;
+    ++pos_;
+    skipWhitespace();
+    if (consume('}')) {
+      return;
+    }
+    std::uint32_t previous = kNone;
+    do {
+      skipWhitespace();
+      if (peek() != '"') {
+        fail("expected a member name");
+      }
+      const std::string_view key = parseString();
+      skipWhitespace();
+      if (!consume(':')) {
+        fail("expected ':' after a member name");
+      }
+      skipWhitespace();
+      previous = addChild(index, previous, key, depth);
+      skipWhitespace();
+    } while (consume(','));
+    if (!consume('}')) {
+      fail("expected ',' or '}' in an object");
+    }
+  }
+
+  void parseArray(std::uint32_t index, std::size_t depth) {
+    document_.nodes_[index].type = Type::Array;
+    ++pos_;
+    skipWhitespace();
+    if (consume(']')) {
+      return;
+    }
+    std::uint32_t previous = kNone;
+    do {
+      skipWhitespace();
+      previous = addChild(index, previous, {}, depth);
+      skipWhitespace();
+    } while (consume(','));
+    if (!consume(']')) {
+      fail("expected ',' or ']' in an array");
+    }
+  }
+
+  // Parses one element of parent and links it after previous.
+  std::uint32_t addChild(std::uint32_t parent, std::uint32_t previous, std::string_view key,
+                         std::size_t depth) {
+    const auto child = static_cast<std::uint32_t>(document_.nodes_.size());
+    if (previous != kNone) {
+      document_.nodes_[previous].next = child;
+    }
+    parseValue(key, depth + 1);
+    ++document_.nodes_[parent].count;
+    return child;
+  }
+
+  // Returns a view into the source, or into the unescape buffer when the
+  // string has escapes. The buffer was reserved to the source size up front
+  // and unescaping only shrinks text, so earlier views stay valid.
+  std::string_view parseString() {
+    ++pos_;
+    const std::size_t start = pos_;
+    while (pos_ < text_.size() && text_[pos_] != '"' && text_[pos_] != '\\') {
+      if (static_cast<unsigned char>(text_[pos_]) < 0x20) {
+        fail("control character in a string");
+      }
+      ++pos_;
+    }
+    if (pos_ >= text_.size()) {
+      fail("unterminated string");
+    }
+    if (text_[pos_] == '"') {
+      return text_.substr(start, pos_++ - start);
+    }
+
+    std::string& out = document_.unescaped_;
+    const std::size_t outStart = out.size();
+    out.append(text_.substr(start, pos_ - start));
+    while (true) {
+      if (pos_ >= text_.size()) {
+        fail("unterminated string");
+      }
+      const char c = text_[pos_++];
+      if (c == '"') {
+        break;
+      }
+      if (static_cast<unsigned char>(c) < 0x20) {
+        fail("control character in a string");
+      }
+      if (c != '\\') {
+        out.push_back(c);
+        continue;
+      }
+      if (pos_ >= text_.size()) {
+        fail("unterminated string");
+      }
+      switch (text_[pos_++]) {
+        case '"':
+          out.push_back('"');
+          break;
+        case '\\':
+          out.push_back('\\');
+          break;
+        case '/':
+          out.push_back('/');
+          break;
+        case 'b':
+          out.push_back('\b');
+          break;
+        case 'f':
+          out.push_back('\f');
+          break;
+        case 'n':
+          out.push_back('\n');
+          break;
+        case 'r':
+          out.push_back('\r');
+          break;
+        case 't':
+          out.push_back('\t');
+          break;
+        case 'u':
+          appendUtf8(out, parseCodepoint());
+          break;
+        default:
+          fail("unknown escape in a string");
+      }
+    }
+    return std::string_view(out).substr(outStart);
+  }
+
+  std::uint32_t parseCodepoint() {
+    std::uint32_t codepoint = parseHex4();
+    if (codepoint >= 0xD800 && codepoint < 0xDC00) {
+      if (text_.substr(pos_, 2) != "\\u") {
+        fail("unpaired surrogate in a string");
+      }
+      pos_ += 2;
+      const std::uint32_t low = parseHex4();
+      if (low < 0xDC00 || low >= 0xE000) {
+        fail("unpaired surrogate in a string");
+      }
+      codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+    } else if (codepoint >= 0xDC00 && codepoint < 0xE000) {
+      fail("unpaired surrogate in a string");
+    }
+    return codepoint;
+  }
+
+  std::uint32_t parseHex4() {
+    std::uint32_t value = 0;
+    const auto* first = text_.data() + pos_;
+    const auto* last = text_.data() + std::min(text_.size(), pos_ + 4);
+    const auto [end, error] = std::from_chars(first, last, value, 16);
+    if (error != std::errc{} || end != first + 4) {
+      fail("bad \\u escape");
+    }
+    pos_ += 4;
+    return value;
+  }
+
+  double parseNumber() {
+    // from_chars takes no leading '+', which JSON does not allow either.
+    double value = 0.0;
+    const auto* first = text_.data() + pos_;
+    const auto [end, error] = std::from_chars(first, text_.data() + text_.size(), value);
+    if (error != std::errc{} || end == first) {
+      fail("expected a value");
+    }
+    // from_chars also reads "inf" and "nan", which are not JSON.
+    if (!std::isfinite(value)) {
+      fail("expected a value");
+    }
+    pos_ += static_cast<std::size_t>(end - first);
+    return value;
+  }
+
+  void expectWord(std::string_view word) {
+    if (text_.substr(pos_, word.size()) != word) {
+      fail("expected a value");
+    }
+    pos_ += word.size();
+  }
+
+  void skipWhitespace() {
+    while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\n' ||
+                                   text_[pos_] == '\r' || text_[pos_] == '\t')) {
+      ++pos_;
+    }
+  }
+
+  [[nodiscard]] char peek() const {
+    return pos_ < text_.size() ? text_[pos_] : '\0';
+  }
+
+  bool consume(char c) {
+    if (peek() != c) {
+      return false;
+    }
+    ++pos_;
+    return true;
+  }
+
+  [[noreturn]] void fail(const std::string& message) const {
+    const auto line = std::count(text_.begin(), text_.begin() + std::min(pos_, text_.size()), '\n');
+    throw std::runtime_error(std::string(sourceName_) + ":" + std::to_string(line + 1) + ": " +
+                             message);
+  }
+
+  JsonDocument& document_;
+  std::string_view text_;
+  std::string_view sourceName_;
+  std::size_t pos_{0};
+};
+
+JsonDocument JsonDocument::parse(std::string_view text, std::string_view sourceName) {
+  JsonDocument document;
+  // Past the small-string buffer, so moving the document keeps the views.
+  document.unescaped_.reserve(std::max<std::size_t>(text.size(), 64));
+  document.nodes_.reserve(maxValueCount(text));
+  Parser(document, text, sourceName).run();
+  return document;
+}
+
+JsonDocument::Value JsonDocument::root() const {
+  return {this, nodes_.empty() ? kNone : 0};
+}
+
+JsonDocument::Value::Value(const JsonDocument* document, std::uint32_t index)
+    : document_(document), index_(index) {}
+
+JsonDocument::Type JsonDocument::Value::type() const {
+  return index_ == kNone ? Type::Null : document_->nodes_[index_].type;
+}
+
+bool JsonDocument::Value::isNull() const {
+  return type() == Type::Null;
+}
+
+bool JsonDocument::Value::isString() const {
+  return type() == Type::String;
+}
+
+bool JsonDocument::Value::isArray() const {
+  return type() == Type::Array;
+}
+
+bool JsonDocument::Value::isObject() const {
+  return type() == Type::Object;
+}
+
+std::string_view JsonDocument::Value::asString(std::string_view fallback) const {
+  return isString() ? document_->nodes_[index_].text : fallback;
+}
+
+double JsonDocument::Value::asNumber(double fallback) const {
+  return type() == Type::Number ? document_->nodes_[index_].number : fallback;
+}
+
+bool JsonDocument::Value::asBool(bool fallback) const {
+  return type() == Type::Bool ? document_->nodes_[index_].boolean : fallback;
+}
+
+std::size_t JsonDocument::Value::size() const {
+  return isArray() || isObject() ? document_->nodes_[index_].count : 0;
+}
+
+JsonDocument::Value JsonDocument::Value::operator[](std::size_t index) const {
+  for (const Value element : *this) {
+    if (index-- == 0) {
+      return element;
+    }
+  }
+  return {document_, kNone};
+}
+
+JsonDocument::Value JsonDocument::Value::operator[](std::string_view key) const {
+  if (isObject()) {
+    for (const Value member : *this) {
+      if (member.key() == key) {
+        return member;
+      }
+    }
+  }
+  return {document_, kNone};
+}
+
+std::string_view JsonDocument::Value::key() const {
+  return index_ == kNone ? std::string_view{} : document_->nodes_[index_].key;
+}
+
+JsonDocument::Value::Iterator JsonDocument::Value::begin() const {
+  const std::size_t count = size();
+  return {document_, count > 0 ? index_ + 1 : kNone, count};
+}
+
+JsonDocument::Value::Iterator JsonDocument::Value::end() const {
+  return {document_, kNone, 0};
+}
+
+JsonDocument::Value::Iterator::Iterator(const JsonDocument* document, std::uint32_t index,
+                                        std::size_t remaining)
+    : document_(document), index_(index), remaining_(remaining) {}
+
+JsonDocument::Value JsonDocument::Value::Iterator::operator*() const {
+  return {document_, index_};
+}
+
+JsonDocument::Value::Iterator& JsonDocument::Value::Iterator::operator++() {
+  index_ = document_->nodes_[index_].next;
+  --remaining_;
+  return *this;
+}
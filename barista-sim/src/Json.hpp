@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only JSON document. Parsing fills a flat array of values in document
+// order, sized up front by a quick scan of the text, so a document costs two
+// allocations however large it is: the value array and one buffer for
+// strings that contain escapes. Every other string is a view into the
+// source text, which must outlive the document.
+class JsonDocument {
+ public:
+  enum class Type : std::uint8_t { Null, Bool, Number, String, Array, Object };
+
+  // Handle to one value. A missing member or element is a Null value, so
+  // lookups chain without checks: doc.root()["script"][0]["line"].
+  class Value {
+   public:
+    class Iterator;
+
+    [[nodiscard]] Type type() const;
+    [[nodiscard]] bool isNull() const;
+    [[nodiscard]] bool isString() const;
+    [[nodiscard]] bool isArray() const;
+    [[nodiscard]] bool isObject() const;
+
+    // These return fallback when the value has another type.
+    [[nodiscard]] std::string_view asString(std::string_view fallback = {}) const;
+    [[nodiscard]] double asNumber(double fallback = 0.0) const;
+    [[nodiscard]] bool asBool(bool fallback = false) const;
+
+    // Elements of an array or members of an object.
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] Value operator[](std::size_t index) const;
+    [[nodiscard]] Value operator[](std::string_view key) const;
+    // Member name when this value sits in an object.
+    [[nodiscard]] std::string_view key() const;
+
+    // Iterates elements or members in document order.
+    [[nodiscard]] Iterator begin() const;
+    [[nodiscard]] Iterator end() const;
+
+   private:
+    friend class JsonDocument;
+    Value(const JsonDocument* document, std::uint32_t index);
+
+    const JsonDocument* document_;
+    std::uint32_t index_;
+  };
+
+  // Throws std::runtime_error naming sourceName and the line of the first
+  // syntax error.
+  static JsonDocument parse(std::string_view text, std::string_view sourceName = "<json>");
+
+  [[nodiscard]] Value root() const;
+
+ private:
+  static constexpr std::uint32_t kNone = ~std::uint32_t{0};
+
+  struct Node {
+    Type type{Type::Null};
+    bool boolean{false};
+    double number{0.0};
+    std::string_view text;
+    std::string_view key;
+    std::uint32_t count{0};
+    // Children follow their parent; next skips the whole subtree.
+    std::uint32_t next{kNone};
+  };
+
+  class Parser;
+
+  std::vector<Node> nodes_;
+  std::string unescaped_;
+};
+
+class JsonDocument::Value::Iterator {
+ public:
+  Value operator*() const;
+  Iterator& operator++();
+  friend bool operator==(const Iterator&, const Iterator&) = default;
+
+ private:
+  friend class Value;
+  Iterator(const JsonDocument* document, std::uint32_t index, std::size_t remaining);
+
+  const JsonDocument* document_;
+  std::uint32_t index_;
+  std::size_t remaining_;
+};
@@ -0,0 +1,76 @@
+#include "LoadingScene.hpp"
+
+#include <string>
+
+#include "AssetLoader.hpp"
+#include "RenderSnapshot.hpp"
+#include "Resources.hpp"
+
+namespace {
+constexpr float kBarWidth = 480.0f;
+constexpr float kBarHeight = 16.0f;
+// Leaves most of a 60 Hz frame for event handling and presenting.
+const sf::Time kUploadBudget = sf::milliseconds(4);
+}  // namespace
+
+LoadingScene::LoadingScene(SceneHost& host, SceneContext context, AssetLoader& loader)
+    : Scene(host, context), loader_(loader) {
+  track_.setSize({kBarWidth, kBarHeight});
+  track_.setOrigin(track_.getSize() * 0.5f);
+  track_.setPosition(640.0f, 380.0f);
+  track_.setFillColor(sf::Color(50, 50, 58));
+
+  bar_.setSize({0.0f, kBarHeight});
+  bar_.setPosition(track_.getPosition() - track_.getOrigin());
+  bar_.setFillColor(sf::Color(255, 214, 153));
+
+  label_.setCharacterSize(20);
+  label_.setFillColor(sf::Color(200, 200, 200));
+  label_.setPosition(track_.getPosition().x - kBarWidth / 2.0f, track_.getPosition().y - 44.0f);
+}
+
+void LoadingScene::handleEvent(const sf::Event& /*event*/) {}
+
+void LoadingScene::update(float /*dt*/) {
+  if (finished_) {
+    return;
+  }
+
+  loader_.pump(kUploadBudget);
+  if (loader_.loadedCount() != displayedCount_) {
+    refreshProgress();
+  }
+
+  if (loader_.done()) {
+    finished_ = true;
+    host().restartSimulation();
+  }
+}
+
+void LoadingScene::draw(sf::RenderTarget& target, float /*alpha*/) {
+  target.draw(track_);
+  target.draw(bar_);
+  if (label_.getFont()) {
+    target.draw(label_);
+  }
+}
+
+void LoadingScene::capture(RenderSnapshot& snapshot) const {
+  snapshot.add(track_);
+  snapshot.add(bar_);
+  if (label_.getFont()) {
+    snapshot.add(label_);
+  }
+}
+
+void LoadingScene::refreshProgress() {
+  displayedCount_ = loader_.loadedCount();
+  bar_.setSize({kBarWidth * loader_.progress(), kBarHeight});
+
+  auto& resources = context().resources;
+  if (!label_.getFont() && resources.hasFont(FontId::Ui)) {
+    label_.setFont(resources.font(FontId::Ui));
+  }
+  label_.setString("Loading " + std::to_string(displayedCount_) + " / " +
+                   std::to_string(loader_.totalCount()));
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Scene.hpp"
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+class AssetLoader;
+
+// Shown while the AssetLoader finishes assets: a progress bar, labelled once
+// the UI font has arrived. Each update spends a small slice of the frame on
+// texture uploads and hands over to the cafe when everything is in.
+class LoadingScene : public Scene {
+ public:
+  LoadingScene(SceneHost& host, SceneContext context, AssetLoader& loader);
+
+  void handleEvent(const sf::Event& event) override;
+  void update(float dt) override;
+  void draw(sf::RenderTarget& target, float alpha) override;
+  void capture(RenderSnapshot& snapshot) const override;
+
+ private:
+  void refreshProgress();
+
+  AssetLoader& loader_;
+  bool finished_{false};
+  std::size_t displayedCount_{0};
+
+  sf::RectangleShape track_;
+  sf::RectangleShape bar_;
+  sf::Text label_;
+};
@@ -1,37 +1,98 @@
 #include "Order.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+constexpr std::string_view kFieldNames[kOrderFieldCount] = {"drink", "size", "milk", "name"};
+}  // namespace
+
 void Order::reset() {
-  drink.clear();
-  size.clear();
-  milk.clear();
-  customerName.clear();
+  filled = 0;
+  nameLength = 0;
 }
 
-bool Order::isComplete() const {
-  return !drink.empty() && !size.empty() && !milk.empty() && !customerName.empty();
+void Order::choose(OrderField field, std::uint8_t item) {
+  switch (field) {
+    case OrderField::Drink:
+      drink = item;
+      break;
+    case OrderField::Size:
+      size = item;
+      break;
+    case OrderField::Milk:
+      milk = item;
+      break;
+    case OrderField::Name:
+      return;
+  }
+  filled |= orderFieldBit(field);
 }
 
-std::vector<std::string> Order::missingFields() const {
-  std::vector<std::string> missing;
-  if (drink.empty()) {
-    missing.emplace_back("drink");
+void Order::setCustomerName(std::string_view customerName) {
+  std::size_t length = std::min(customerName.size(), kMaxNameBytes);
+  // Back off continuation bytes so a cut never splits a UTF-8 sequence.
+  if (length < customerName.size()) {
+    while (length > 0 && (static_cast<unsigned char>(customerName[length]) & 0xC0) == 0x80) {
+      --length;
+    }
   }
-  if (size.empty()) {
-    missing.emplace_back("size");
+  std::copy_n(customerName.data(), length, name.data());
+  nameLength = static_cast<std::uint8_t>(length);
+  if (length > 0) {
+    filled |= orderFieldBit(OrderField::Name);
+  } else {
+    filled &= static_cast<OrderFieldMask>(~orderFieldBit(OrderField::Name));
   }
-  if (milk.empty()) {
-    missing.emplace_back("milk");
+}
+
+std::string_view Order::customerName() const {
+  return std::string_view(name.data(), nameLength);
+}
+
+bool Order::has(OrderField field) const {
+  return (filled & orderFieldBit(field)) != 0;
+}
+
+OrderFieldMask Order::missingFields() const {
+  return static_cast<OrderFieldMask>(kAllOrderFields & ~filled);
+}
+
+bool Order::isComplete() const {
+  return missingFields() == 0;
+}
+
+OrderFieldMask validateOrder(const Order& order, OrderFieldMask required) {
+  return static_cast<OrderFieldMask>(order.missingFields() & required);
+}
+
+std::size_t validateOrders(std::span<const Order> orders, std::span<OrderFieldMask> missing,
+                           OrderFieldMask required) {
+  if (missing.size() < orders.size()) {
+    throw std::invalid_argument("validateOrders: missing is shorter than orders");
   }
-  if (customerName.empty()) {
-    missing.emplace_back("name");
+  std::size_t complete = 0;
+  for (std::size_t i = 0; i < orders.size(); ++i) {
+    missing[i] = validateOrder(orders[i], required);
+    complete += missing[i] == 0 ? 1 : 0;
   }
-  return missing;
+  return complete;
 }
 
-OrderValidation validateOrder(const Order& order) {
-  OrderValidation result;
-  result.missing = order.missingFields();
-  result.complete = result.missing.empty();
-  return result;
+std::string_view orderFieldName(OrderField field) {
+  return kFieldNames[static_cast<std::size_t>(field)];
 }
 
+std::string describeOrderFields(OrderFieldMask fields) {
+  std::string text;
+  for (std::size_t field = 0; field < kOrderFieldCount; ++field) {
+    if ((fields & orderFieldBit(static_cast<OrderField>(field))) == 0) {
+      continue;
+    }
+    if (!text.empty()) {
+      text += ", ";
+    }
+    text += kFieldNames[field];
+  }
+  return text;
+}
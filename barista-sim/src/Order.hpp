@@ -1,29 +1,59 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string>
-#include <vector>
+#include <string_view>
 
+// Fields an order needs, as bit positions in an OrderFieldMask.
+enum class OrderField : std::uint8_t { Drink, Size, Milk, Name };
+inline constexpr std::size_t kOrderFieldCount = 4;
+
+using OrderFieldMask = std::uint8_t;
+inline constexpr OrderFieldMask kAllOrderFields = (1U << kOrderFieldCount) - 1;
+
+[[nodiscard]] constexpr OrderFieldMask orderFieldBit(OrderField field) {
+  return static_cast<OrderFieldMask>(1U << static_cast<unsigned>(field));
+}
+
+// A customer's order as plain data: the drink, size and milk are indices into
+// the scenario's menu lists (DialogueGraph::menu), filled marks which fields
+// have been given, and the name lives in an inline buffer. Copying or
+// validating one never allocates.
 struct Order {
-  std::string drink;
-  std::string size;
-  std::string milk;
-  std::string customerName;
+  // Longer names are cut at a character boundary.
+  static constexpr std::size_t kMaxNameBytes = 31;
 
-  void reset();
-  [[nodiscard]] bool isComplete() const;
-  [[nodiscard]] std::vector<std::string> missingFields() const;
-};
+  std::uint8_t drink{0};
+  std::uint8_t size{0};
+  std::uint8_t milk{0};
+  OrderFieldMask filled{0};
+  std::uint8_t nameLength{0};
+  std::array<char, kMaxNameBytes> name{};
 
-struct MenuOptions {
-  std::vector<std::string> drinks;
-  std::vector<std::string> sizes;
-  std::vector<std::string> milks;
-};
+  void reset();
+  // Records the menu item chosen for drink, size or milk.
+  void choose(OrderField field, std::uint8_t item);
+  void setCustomerName(std::string_view customerName);
 
-struct OrderValidation {
-  bool complete{false};
-  std::vector<std::string> missing;
+  [[nodiscard]] std::string_view customerName() const;
+  [[nodiscard]] bool has(OrderField field) const;
+  [[nodiscard]] OrderFieldMask missingFields() const;
+  [[nodiscard]] bool isComplete() const;
 };
 
-OrderValidation validateOrder(const Order& order);
+// Fields of required still missing from order; zero when it is complete.
+[[nodiscard]] OrderFieldMask validateOrder(const Order& order,
+                                          OrderFieldMask required = kAllOrderFields);
+// Writes each order's missing fields of required to missing and returns how
+// many orders are complete. Throws std::invalid_argument when missing is
+// shorter.
+std::size_t validateOrders(std::span<const Order> orders, std::span<OrderFieldMask> missing,
+                           OrderFieldMask required = kAllOrderFields);
 
+// Lowercase field name, as shown in reports.
+[[nodiscard]] std::string_view orderFieldName(OrderField field);
+// "drink, milk" for a mask; empty when nothing is missing.
+[[nodiscard]] std::string describeOrderFields(OrderFieldMask fields);
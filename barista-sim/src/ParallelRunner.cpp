@@ -0,0 +1,135 @@
+#include "ParallelRunner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "InputRecording.hpp"
+#include "InputScript.hpp"
+
+ParallelRunner::ParallelRunner(const HeadlessAssets& assets, HeadlessConfig config,
+                               ParallelConfig parallel)
+    : assets_(assets), config_(std::move(config)), parallel_(parallel) {
+  config_.workerThreads = 0;
+}
+
+std::size_t ParallelRunner::runSessions(const InputScript& script, std::size_t sessions,
+                                        const ReportSink& sink) {
+  return run(
+      sessions, [&script](HeadlessRunner& runner, std::size_t) { runner.begin(script); }, sink);
+}
+
+std::size_t ParallelRunner::runReplays(const std::vector<InputRecording>& recordings,
+                                       std::size_t sessions, const ReportSink& sink) {
+  // Session i replays recording i / sessions, the order runHeadlessReplays
+  // plays them in.
+  return run(
+      recordings.size() * sessions,
+      [&recordings, sessions](HeadlessRunner& runner, std::size_t index) {
+        runner.begin(recordings[index / sessions]);
+      },
+      sink);
+}
+
+unsigned ParallelRunner::threadsFor(std::size_t sessions) const {
+  unsigned threads = parallel_.threads;
+  if (threads == JobSystem::kAutomatic) {
+    threads = std::thread::hardware_concurrency();
+  }
+  return static_cast<unsigned>(std::min<std::size_t>(std::max(threads, 1U), sessions));
+}
+
+std::size_t ParallelRunner::run(std::size_t sessions, const SessionStarter& start,
+                                const ReportSink& sink) {
+  const unsigned threadCount = threadsFor(sessions);
+  if (threadCount == 0) {
+    return 0;
+  }
+
+  std::atomic<std::size_t> nextSession{0};
+  std::atomic<bool> failed{false};
+  // Guards sink, reported and error.
+  std::mutex mutex;
+  std::size_t reported = 0;
+  std::exception_ptr error;
+  // Lock-step: every world arrives here after each tick. A thread with no
+  // sessions left drops out, so the rest keep going without it.
+  std::optional<std::barrier<>> tickDone;
+  if (parallel_.mode == ParallelMode::LockStep) {
+    tickDone.emplace(static_cast<std::ptrdiff_t>(threadCount));
+  }
+
+  const auto work = [&] {
+    try {
+      HeadlessRunner runner(assets_, config_);
+      const auto startNext = [&] {
+        const std::size_t index = nextSession.fetch_add(1, std::memory_order_relaxed);
+        if (index >= sessions || failed.load(std::memory_order_relaxed)) {
+          return false;
+        }
+        start(runner, index);
+        return true;
+      };
+
+      for (bool active = startNext(); active;) {
+        if (!runner.step()) {
+          if (const auto report = runner.finish()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sink(*report);
+            ++reported;
+          }
+          active = startNext();
+        }
+        if (tickDone) {
+          tickDone->arrive_and_wait();
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      failed = true;
+    }
+    if (tickDone) {
+      tickDone->arrive_and_drop();
+    }
+  };
+
+  // The calling thread drives one of the worlds itself.
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for (unsigned i = 1; i < threadCount; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return reported;
+}
+
+std::size_t runParallelSessions(const InputScript& script, std::size_t sessions,
+                                HeadlessConfig config, ParallelConfig parallel,
+                                const ReportSink& sink) {
+  const HeadlessAssets assets(config.scenarioPath);
+  ParallelRunner runner(assets, std::move(config), parallel);
+  return runner.runSessions(script, sessions, sink);
+}
+
+std::size_t runParallelReplays(const std::vector<InputRecording>& recordings,
+                               std::size_t sessions, HeadlessConfig config,
+                               ParallelConfig parallel, const ReportSink& sink) {
+  const HeadlessAssets assets(config.scenarioPath);
+  ParallelRunner runner(assets, std::move(config), parallel);
+  return runner.runReplays(recordings, sessions, sink);
+}
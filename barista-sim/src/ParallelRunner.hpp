@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "HeadlessRunner.hpp"
+
+enum class ParallelMode : std::uint8_t {
+  // Every thread starts its next session as soon as the last one ends; the
+  // fastest way through a batch.
+  FreeRunning,
+  // Every world finishes tick t before any starts tick t + 1, so the worlds
+  // stay at the same simulated time, e.g. to compare sessions tick by tick.
+  LockStep,
+};
+
+struct ParallelConfig {
+  // Worlds ticking at once, one per thread; kAutomatic runs one per
+  // hardware thread. Never more than there are sessions.
+  unsigned threads{JobSystem::kAutomatic};
+  ParallelMode mode{ParallelMode::FreeRunning};
+};
+
+// Runs batches of headless sessions across threads. Each thread owns one
+// HeadlessRunner, and with it one CafeScene world at a time with its own
+// input, audio and job system, for the whole batch; the only things the
+// threads share are the read-only HeadlessAssets. Nothing a session computes
+// depends on the thread it ran on or on its neighbours, so the reports are
+// the same as one HeadlessRunner's, though they arrive in completion order.
+//
+// Each world runs its crowd inline (HeadlessConfig::workerThreads is
+// ignored): the threads already fill the cores.
+class ParallelRunner {
+ public:
+  // assets must outlive the runner.
+  ParallelRunner(const HeadlessAssets& assets, HeadlessConfig config,
+                 ParallelConfig parallel = {});
+
+  // Like runHeadlessSessions. sink is called from the worker threads, one
+  // call at a time. Returns the number of sessions that reported. If a
+  // session throws, the others stop and the first exception is rethrown.
+  std::size_t runSessions(const InputScript& script, std::size_t sessions,
+                          const ReportSink& sink);
+  // Like runHeadlessReplays: every recording `sessions` times.
+  std::size_t runReplays(const std::vector<InputRecording>& recordings, std::size_t sessions,
+                         const ReportSink& sink);
+
+  // Threads a batch of `sessions` would use.
+  [[nodiscard]] unsigned threadsFor(std::size_t sessions) const;
+
+ private:
+  // Starts session `index` of the batch on runner.
+  using SessionStarter = std::function<void(HeadlessRunner& runner, std::size_t index)>;
+
+  std::size_t run(std::size_t sessions, const SessionStarter& start, const ReportSink& sink);
+
+  const HeadlessAssets& assets_;
+  HeadlessConfig config_;
+  ParallelConfig parallel_;
+};
+
+// Loads the shared headless assets once and runs the batch with a
+// ParallelRunner.
+std::size_t runParallelSessions(const InputScript& script, std::size_t sessions,
+                                HeadlessConfig config, ParallelConfig parallel,
+                                const ReportSink& sink);
+std::size_t runParallelReplays(const std::vector<InputRecording>& recordings,
+                               std::size_t sessions, HeadlessConfig config,
+                               ParallelConfig parallel, const ReportSink& sink);
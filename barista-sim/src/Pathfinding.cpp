@@ -1,45 +1,738 @@
 #include "Pathfinding.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
 
-#include "Utils.hpp"
+namespace {
+constexpr float kSqrt2 = 1.41421356f;
 
-void PathFollower::setPath(std::vector<sf::Vector2f> nodes) {
-  nodes_ = std::move(nodes);
-  current_ = 0;
+// Same floor as SpatialHash: std::floor is a libm call on baseline x86-64.
+[[nodiscard]] std::int64_t floorToInt(float value) {
+  const auto truncated = static_cast<std::int64_t>(value);
+  return truncated - (value < static_cast<float>(truncated) ? 1 : 0);
 }
 
-void PathFollower::setSpeed(float speed) {
-  speed_ = speed;
+// 8-way moves, ordered so that move 7 - k undoes move k.
+constexpr std::array<std::array<std::int64_t, 2>, 8> kMoves = {{
+    {-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1},
+}};
+constexpr std::uint32_t kStraightCost = 5;
+constexpr std::uint32_t kDiagonalCost = 7;
+
+[[nodiscard]] bool isDiagonal(std::size_t move) {
+  return kMoves[move][0] != 0 && kMoves[move][1] != 0;
 }
 
-void PathFollower::reset() {
-  current_ = 0;
+// Calls visit(neighbour, move) for each of cell's in-bounds neighbours.
+template <typename Visit>
+void forEachNeighbour(const NavGrid& grid, NavGrid::Cell cell, Visit&& visit) {
+  const auto width = static_cast<std::int64_t>(grid.width());
+  const auto height = static_cast<std::int64_t>(grid.height());
+  const std::int64_t x = cell % width;
+  const std::int64_t y = cell / width;
+  for (std::size_t move = 0; move < kMoves.size(); ++move) {
+    const std::int64_t nx = x + kMoves[move][0];
+    const std::int64_t ny = y + kMoves[move][1];
+    if (nx >= 0 && ny >= 0 && nx < width && ny < height) {
+      visit(static_cast<NavGrid::Cell>(ny * width + nx), move);
+    }
+  }
 }
 
-void PathFollower::update(float dt, sf::Vector2f& position) {
-  if (nodes_.empty() || current_ >= nodes_.size()) {
-    return;
+// The solver's move rule: onto a walkable cell, and diagonally only between
+// two walkable side cells. Assumes cell itself is walkable.
+[[nodiscard]] bool canMove(const NavGrid& grid, NavGrid::Cell cell, std::size_t move) {
+  const auto width = static_cast<std::int64_t>(grid.width());
+  const std::int64_t x = cell % width;
+  const std::int64_t y = cell / width;
+  const std::int64_t nx = x + kMoves[move][0];
+  const std::int64_t ny = y + kMoves[move][1];
+  if (nx < 0 || ny < 0 || nx >= width || ny >= static_cast<std::int64_t>(grid.height()) ||
+      !grid.walkable(static_cast<NavGrid::Cell>(ny * width + nx))) {
+    return false;
+  }
+  return !isDiagonal(move) || (grid.walkable(static_cast<NavGrid::Cell>(y * width + nx)) &&
+                               grid.walkable(static_cast<NavGrid::Cell>(ny * width + x)));
+}
+
+// Calls visit(neighbour, move) for each move canMove() allows out of cell.
+template <typename Visit>
+void forEachMove(const NavGrid& grid, NavGrid::Cell cell, Visit&& visit) {
+  const auto width = static_cast<std::int64_t>(grid.width());
+  const auto height = static_cast<std::int64_t>(grid.height());
+  // 32-bit division is markedly cheaper than 64-bit on x86-64.
+  const std::uint32_t row = cell / grid.width();
+  const std::int64_t x = cell - row * grid.width();
+  const std::int64_t y = row;
+  // Walkability of the 3x3 block around cell, row by row; off-grid is blocked.
+  std::array<bool, 9> open{};
+  for (std::int64_t dy = -1; dy <= 1; ++dy) {
+    for (std::int64_t dx = -1; dx <= 1; ++dx) {
+      const std::int64_t nx = x + dx;
+      const std::int64_t ny = y + dy;
+      open[static_cast<std::size_t>((dy + 1) * 3 + dx + 1)] =
+          nx >= 0 && ny >= 0 && nx < width && ny < height &&
+          grid.walkable(static_cast<NavGrid::Cell>(ny * width + nx));
+    }
+  }
+  for (std::size_t move = 0; move < kMoves.size(); ++move) {
+    const std::int64_t dx = kMoves[move][0];
+    const std::int64_t dy = kMoves[move][1];
+    if (!open[static_cast<std::size_t>((dy + 1) * 3 + dx + 1)] ||
+        (dx != 0 && dy != 0 &&
+         (!open[static_cast<std::size_t>(4 + dx)] || !open[static_cast<std::size_t>(4 + dy * 3)]))) {
+      continue;
+    }
+    visit(static_cast<NavGrid::Cell>((y + dy) * width + x + dx), move);
+  }
+}
+
+[[nodiscard]] NavGrid::Cell applyMove(const NavGrid& grid, NavGrid::Cell cell, std::size_t move) {
+  const auto width = static_cast<std::int64_t>(grid.width());
+  return static_cast<NavGrid::Cell>(static_cast<std::int64_t>(cell) + kMoves[move][1] * width +
+                                    kMoves[move][0]);
+}
+}  // namespace
+
+void NavGrid::bake(const sf::FloatRect& area, float cellSize,
+                   std::span<const sf::FloatRect> colliders, const sf::Vector2f& agentHalfSize) {
+  const sf::Vector2f origin{area.left, area.top};
+  const float size = std::max(cellSize, 1.0f);
+  const auto width = static_cast<std::uint32_t>(std::ceil(std::max(area.width, 0.0f) / size));
+  const auto height = static_cast<std::uint32_t>(std::ceil(std::max(area.height, 0.0f) / size));
+  layoutChanged_ = origin != origin_ || size != cellSize_ || width != width_ ||
+                   height != height_ || blocked_.size() != cellCount();
+  origin_ = origin;
+  cellSize_ = size;
+  width_ = width;
+  height_ = height;
+  previous_.swap(blocked_);
+  blocked_.assign(cellCount(), 0);
+
+  for (const sf::FloatRect& collider : colliders) {
+    // Growing the collider by the agent's half size turns "box overlaps
+    // collider" into "centre inside the grown box".
+    const float left = collider.left - agentHalfSize.x;
+    const float top = collider.top - agentHalfSize.y;
+    const float right = collider.left + collider.width + agentHalfSize.x;
+    const float bottom = collider.top + collider.height + agentHalfSize.y;
+
+    const auto clampX = [this](std::int64_t x) {
+      return std::clamp<std::int64_t>(x, 0, static_cast<std::int64_t>(width_) - 1);
+    };
+    const auto clampY = [this](std::int64_t y) {
+      return std::clamp<std::int64_t>(y, 0, static_cast<std::int64_t>(height_) - 1);
+    };
+    const std::int64_t minX = clampX(floorToInt((left - origin_.x) / cellSize_));
+    const std::int64_t maxX = clampX(floorToInt((right - origin_.x) / cellSize_));
+    const std::int64_t minY = clampY(floorToInt((top - origin_.y) / cellSize_));
+    const std::int64_t maxY = clampY(floorToInt((bottom - origin_.y) / cellSize_));
+
+    for (std::int64_t y = minY; y <= maxY; ++y) {
+      const float cellTop = origin_.y + static_cast<float>(y) * cellSize_;
+      if (!(cellTop < bottom && top < cellTop + cellSize_)) {
+        continue;
+      }
+      for (std::int64_t x = minX; x <= maxX; ++x) {
+        const float cellLeft = origin_.x + static_cast<float>(x) * cellSize_;
+        if (cellLeft < right && left < cellLeft + cellSize_) {
+          blocked_[static_cast<std::size_t>(y) * width_ + static_cast<std::size_t>(x)] = 1;
+        }
+      }
+    }
+  }
+
+  changed_.clear();
+  if (!layoutChanged_) {
+    for (std::size_t cell = 0; cell < blocked_.size(); ++cell) {
+      if (blocked_[cell] != previous_[cell]) {
+        changed_.push_back(static_cast<Cell>(cell));
+      }
+    }
+  }
+}
+
+bool NavGrid::layoutChanged() const {
+  return layoutChanged_;
+}
+
+std::span<const NavGrid::Cell> NavGrid::changedCells() const {
+  return changed_;
+}
+
+std::uint32_t NavGrid::width() const {
+  return width_;
+}
+
+std::uint32_t NavGrid::height() const {
+  return height_;
+}
+
+std::size_t NavGrid::cellCount() const {
+  return static_cast<std::size_t>(width_) * height_;
+}
+
+float NavGrid::cellSize() const {
+  return cellSize_;
+}
+
+NavGrid::Cell NavGrid::cellAt(const sf::Vector2f& point) const {
+  const std::int64_t x = floorToInt((point.x - origin_.x) / cellSize_);
+  const std::int64_t y = floorToInt((point.y - origin_.y) / cellSize_);
+  if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+    return kNoCell;
   }
+  return static_cast<Cell>(y * width_ + x);
+}
+
+sf::Vector2f NavGrid::center(Cell cell) const {
+  return {origin_.x + (static_cast<float>(cell % width_) + 0.5f) * cellSize_,
+          origin_.y + (static_cast<float>(cell / width_) + 0.5f) * cellSize_};
+}
 
-  const sf::Vector2f target = nodes_[current_];
-  sf::Vector2f toTarget = target - position;
-  const float distance = utils::length(toTarget);
+bool NavGrid::walkable(Cell cell) const {
+  return cell < blocked_.size() && blocked_[cell] == 0;
+}
 
-  if (distance < 4.0f) {
-    current_ = std::min(current_ + 1, nodes_.size());
+NavGrid::Cell NavGrid::nearestWalkable(Cell cell) const {
+  if (cell >= blocked_.size() || walkable(cell)) {
+    return cell >= blocked_.size() ? kNoCell : cell;
+  }
+
+  const auto cx = static_cast<std::int64_t>(cell % width_);
+  const auto cy = static_cast<std::int64_t>(cell / width_);
+  const std::int64_t maxRing = std::max(width_, height_);
+  for (std::int64_t ring = 1; ring <= maxRing; ++ring) {
+    Cell best = kNoCell;
+    std::int64_t bestDistance = std::numeric_limits<std::int64_t>::max();
+    const auto consider = [&](std::int64_t x, std::int64_t y) {
+      const std::int64_t distance = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      if (walkableAt(x, y) && distance < bestDistance) {
+        bestDistance = distance;
+        best = static_cast<Cell>(y * width_ + x);
+      }
+    };
+    for (std::int64_t offset = -ring; offset <= ring; ++offset) {
+      consider(cx + offset, cy - ring);
+      consider(cx + offset, cy + ring);
+      if (offset > -ring && offset < ring) {
+        consider(cx - ring, cy + offset);
+        consider(cx + ring, cy + offset);
+      }
+    }
+    if (best != kNoCell) {
+      return best;
+    }
+  }
+  return kNoCell;
+}
+
+bool NavGrid::visible(const sf::Vector2f& from, const sf::Vector2f& to) const {
+  // Grid traversal (Amanatides & Woo) visiting every cell the segment
+  // touches. Passing exactly through a corner needs both side cells, the
+  // same no-corner-cutting rule the solver uses.
+  const float fromX = (from.x - origin_.x) / cellSize_;
+  const float fromY = (from.y - origin_.y) / cellSize_;
+  const float toX = (to.x - origin_.x) / cellSize_;
+  const float toY = (to.y - origin_.y) / cellSize_;
+
+  std::int64_t x = floorToInt(fromX);
+  std::int64_t y = floorToInt(fromY);
+  const std::int64_t endX = floorToInt(toX);
+  const std::int64_t endY = floorToInt(toY);
+  if (!walkableAt(x, y)) {
+    return false;
+  }
+
+  const float dx = std::abs(toX - fromX);
+  const float dy = std::abs(toY - fromY);
+  const std::int64_t stepX = toX > fromX ? 1 : -1;
+  const std::int64_t stepY = toY > fromY ? 1 : -1;
+  constexpr float kNever = std::numeric_limits<float>::infinity();
+  const float deltaX = dx > 0.0f ? 1.0f / dx : kNever;
+  const float deltaY = dy > 0.0f ? 1.0f / dy : kNever;
+  float nextX = dx > 0.0f ? (stepX > 0 ? static_cast<float>(x + 1) - fromX
+                                        : fromX - static_cast<float>(x)) * deltaX
+                          : kNever;
+  float nextY = dy > 0.0f ? (stepY > 0 ? static_cast<float>(y + 1) - fromY
+                                        : fromY - static_cast<float>(y)) * deltaY
+                          : kNever;
+
+  for (std::int64_t remaining = std::abs(endX - x) + std::abs(endY - y); remaining > 0;
+       --remaining) {
+    if (nextX < nextY) {
+      x += stepX;
+      nextX += deltaX;
+    } else if (nextY < nextX) {
+      y += stepY;
+      nextY += deltaY;
+    } else {
+      if (!walkableAt(x + stepX, y) || !walkableAt(x, y + stepY)) {
+        return false;
+      }
+      x += stepX;
+      y += stepY;
+      nextX += deltaX;
+      nextY += deltaY;
+      --remaining;
+    }
+    if (!walkableAt(x, y)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NavGrid::walkableAt(std::int64_t x, std::int64_t y) const {
+  return x >= 0 && y >= 0 && x < width_ && y < height_ &&
+         blocked_[static_cast<std::size_t>(y) * width_ + static_cast<std::size_t>(x)] == 0;
+}
+
+bool GridPathSolver::solve(const NavGrid& grid, Cell start, Cell goal,
+                           std::vector<sf::Vector2f>& path) {
+  path.clear();
+  expanded_ = 0;
+  if (!grid.walkable(start) || !grid.walkable(goal)) {
+    return false;
+  }
+  prepare(grid);
+
+  const auto width = static_cast<std::int64_t>(grid.width());
+  const auto height = static_cast<std::int64_t>(grid.height());
+  const float straight = grid.cellSize();
+  const float diagonal = straight * kSqrt2;
+  const std::int64_t goalX = goal % width;
+  const std::int64_t goalY = goal / width;
+  const auto heuristic = [&](std::int64_t x, std::int64_t y) {
+    const auto dx = static_cast<float>(std::abs(x - goalX));
+    const auto dy = static_cast<float>(std::abs(y - goalY));
+    return straight * (dx + dy) + (diagonal - 2.0f * straight) * std::min(dx, dy);
+  };
+  // Min-heap on f; equal f pops the lower cell so searches are reproducible.
+  const auto later = [](const OpenEntry& a, const OpenEntry& b) {
+    return a.f > b.f || (a.f == b.f && a.cell > b.cell);
+  };
+  const auto open = [&](Cell cell, float cost, Cell parent, std::int64_t x, std::int64_t y) {
+    seen_[cell] = stamp_;
+    cost_[cell] = cost;
+    parent_[cell] = parent;
+    open_.push_back({cost + heuristic(x, y), cell});
+    std::push_heap(open_.begin(), open_.end(), later);
+  };
+
+  open_.clear();
+  open(start, 0.0f, start, start % width, start / width);
+
+  while (!open_.empty()) {
+    std::pop_heap(open_.begin(), open_.end(), later);
+    const Cell cell = open_.back().cell;
+    open_.pop_back();
+    // The heap keeps superseded entries instead of decreasing keys in place.
+    if (closed_[cell] == stamp_) {
+      continue;
+    }
+    closed_[cell] = stamp_;
+    ++expanded_;
+
+    if (cell == goal) {
+      buildPath(grid, start, goal, path);
+      return true;
+    }
+
+    const std::int64_t x = cell % width;
+    const std::int64_t y = cell / width;
+    for (std::int64_t dy = -1; dy <= 1; ++dy) {
+      for (std::int64_t dx = -1; dx <= 1; ++dx) {
+        const std::int64_t nx = x + dx;
+        const std::int64_t ny = y + dy;
+        if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= width || ny >= height) {
+          continue;
+        }
+        const auto next = static_cast<Cell>(ny * width + nx);
+        if (!grid.walkable(next) || closed_[next] == stamp_) {
+          continue;
+        }
+        const bool isDiagonal = dx != 0 && dy != 0;
+        if (isDiagonal && (!grid.walkable(static_cast<Cell>(y * width + nx)) ||
+                           !grid.walkable(static_cast<Cell>(ny * width + x)))) {
+          continue;
+        }
+        const float cost = cost_[cell] + (isDiagonal ? diagonal : straight);
+        if (seen_[next] != stamp_ || cost < cost_[next]) {
+          open(next, cost, cell, nx, ny);
+        }
+      }
+    }
+  }
+  return false;
+}
+
+std::size_t GridPathSolver::lastExpanded() const {
+  return expanded_;
+}
+
+void GridPathSolver::prepare(const NavGrid& grid) {
+  const std::size_t count = grid.cellCount();
+  if (cost_.size() != count) {
+    cost_.assign(count, 0.0f);
+    parent_.assign(count, 0);
+    seen_.assign(count, 0);
+    closed_.assign(count, 0);
+    open_.reserve(count);
+    stamp_ = 0;
+  }
+  if (++stamp_ == 0) {
+    std::fill(seen_.begin(), seen_.end(), 0);
+    std::fill(closed_.begin(), closed_.end(), 0);
+    stamp_ = 1;
+  }
+}
+
+void GridPathSolver::buildPath(const NavGrid& grid, Cell start, Cell goal,
+                               std::vector<sf::Vector2f>& path) {
+  cells_.clear();
+  for (Cell cell = goal; cell != start; cell = parent_[cell]) {
+    cells_.push_back(cell);
+  }
+  std::reverse(cells_.begin(), cells_.end());
+
+  // String pulling: from each waypoint, jump to the furthest later cell in
+  // line of sight.
+  sf::Vector2f anchor = grid.center(start);
+  for (std::size_t i = 0; i < cells_.size();) {
+    std::size_t furthest = i;
+    while (furthest + 1 < cells_.size() && grid.visible(anchor, grid.center(cells_[furthest + 1]))) {
+      ++furthest;
+    }
+    anchor = grid.center(cells_[furthest]);
+    path.push_back(anchor);
+    i = furthest + 1;
+  }
+}
+
+PathCache::PathCache(std::size_t capacity) : capacity_(std::max<std::size_t>(capacity, 1)) {
+  slots_.reserve(capacity_);
+  lookup_.reserve(capacity_);
+}
+
+const PathCache::Entry* PathCache::find(Cell start, Cell goal) {
+  const auto found = lookup_.find((std::uint64_t{start} << 32) | goal);
+  if (found == lookup_.end()) {
+    return nullptr;
+  }
+  const std::uint32_t slot = found->second;
+  if (slot != newest_) {
+    unlink(slot);
+    pushNewest(slot);
+  }
+  return &slots_[slot].entry;
+}
+
+PathCache::Entry& PathCache::insert(Cell start, Cell goal) {
+  const std::uint64_t key = (std::uint64_t{start} << 32) | goal;
+  std::uint32_t slot;
+  if (const auto found = lookup_.find(key); found != lookup_.end()) {
+    slot = found->second;
+    unlink(slot);
+  } else if (slots_.size() < capacity_) {
+    slot = static_cast<std::uint32_t>(slots_.size());
+    slots_.emplace_back();
+    lookup_.emplace(key, slot);
+  } else {
+    slot = oldest_;
+    unlink(slot);
+    lookup_.erase(slots_[slot].key);
+    lookup_.emplace(key, slot);
+  }
+
+  Slot& target = slots_[slot];
+  target.key = key;
+  target.entry.found = false;
+  target.entry.path.clear();
+  pushNewest(slot);
+  return target.entry;
+}
+
+void PathCache::clear() {
+  slots_.clear();
+  lookup_.clear();
+  newest_ = kNone;
+  oldest_ = kNone;
+}
+
+std::size_t PathCache::size() const {
+  return slots_.size();
+}
+
+void PathCache::unlink(std::uint32_t slot) {
+  Slot& entry = slots_[slot];
+  if (entry.newer != kNone) {
+    slots_[entry.newer].older = entry.older;
+  } else {
+    newest_ = entry.older;
+  }
+  if (entry.older != kNone) {
+    slots_[entry.older].newer = entry.newer;
+  } else {
+    oldest_ = entry.newer;
+  }
+  entry.newer = kNone;
+  entry.older = kNone;
+}
+
+void PathCache::pushNewest(std::uint32_t slot) {
+  Slot& entry = slots_[slot];
+  entry.newer = kNone;
+  entry.older = newest_;
+  if (newest_ != kNone) {
+    slots_[newest_].newer = slot;
+  }
+  newest_ = slot;
+  if (oldest_ == kNone) {
+    oldest_ = slot;
+  }
+}
+
+Pathfinder::Pathfinder(std::size_t cacheCapacity) : cache_(cacheCapacity) {}
+
+void Pathfinder::setGrid(const NavGrid& grid) {
+  grid_ = &grid;
+  cache_.clear();
+}
+
+bool Pathfinder::findPath(const sf::Vector2f& from, const sf::Vector2f& to,
+                          std::vector<sf::Vector2f>& path) {
+  path.clear();
+  if (grid_ == nullptr) {
+    return false;
+  }
+  const NavGrid& grid = *grid_;
+  const NavGrid::Cell fromCell = grid.cellAt(from);
+  const NavGrid::Cell toCell = grid.cellAt(to);
+  if (fromCell == NavGrid::kNoCell || toCell == NavGrid::kNoCell) {
+    return false;
+  }
+
+  // Keyed by the raw cells, so a hit skips snapping blocked ends as well.
+  const PathCache::Entry* entry = cache_.find(fromCell, toCell);
+  if (entry) {
+    ++hits_;
+  } else {
+    ++misses_;
+    PathCache::Entry& solved = cache_.insert(fromCell, toCell);
+    const NavGrid::Cell start = grid.nearestWalkable(fromCell);
+    const NavGrid::Cell goal = grid.nearestWalkable(toCell);
+    solved.found = start != NavGrid::kNoCell && goal != NavGrid::kNoCell &&
+                   solver_.solve(grid, start, goal, solved.path);
+    if (solved.found && solved.path.empty()) {
+      solved.path.push_back(grid.center(goal));
+    }
+    entry = &solved;
+  }
+  if (!entry->found) {
+    return false;
+  }
+
+  path.assign(entry->path.begin(), entry->path.end());
+  if (grid.walkable(toCell)) {
+    // Finish on the exact target: it shares the walkable goal cell, so only
+    // the last leg needs a fresh line-of-sight check.
+    const sf::Vector2f legStart = path.size() >= 2
+                                      ? path[path.size() - 2]
+                                      : grid.center(grid.nearestWalkable(fromCell));
+    if (grid.visible(legStart, to)) {
+      path.back() = to;
+    } else {
+      path.push_back(to);
+    }
+  }
+  return true;
+}
+
+std::size_t Pathfinder::cacheHits() const {
+  return hits_;
+}
+
+std::size_t Pathfinder::cacheMisses() const {
+  return misses_;
+}
+
+void FlowField::build(const NavGrid& grid, std::span<const sf::Vector2f> goals) {
+  grid_ = &grid;
+  goalPositions_.assign(goals.begin(), goals.end());
+  rebuild();
+}
+
+void FlowField::update() {
+  if (grid_ == nullptr) {
     return;
   }
+  if (grid_->layoutChanged() || cost_.size() != grid_->cellCount()) {
+    rebuild();
+    return;
+  }
+  const std::span<const Cell> changed = grid_->changedCells();
+  if (changed.empty()) {
+    settled_ = 0;
+    return;
+  }
+  for (std::size_t i = 0; i < goals_.size(); ++i) {
+    if (grid_->nearestWalkable(grid_->cellAt(goalPositions_[i])) != goals_[i]) {
+      rebuild();
+      return;
+    }
+  }
 
-  toTarget = utils::normalize(toTarget);
-  position += toTarget * speed_ * dt;
+  // Drop every cell whose stored move the grid now forbids (its target or a
+  // corner it passes got blocked), then everything routed through those.
+  invalid_.clear();
+  for (const Cell cell : changed) {
+    if (!grid_->walkable(cell)) {
+      invalidate(cell);
+    }
+  }
+  for (const Cell cell : changed) {
+    forEachNeighbour(*grid_, cell, [this](Cell neighbour, std::size_t) {
+      if (step_[neighbour] != kNoStep && !stepLegal(neighbour)) {
+        invalidate(neighbour);
+      }
+    });
+  }
+  for (std::size_t i = 0; i < invalid_.size(); ++i) {
+    const Cell lost = invalid_[i];
+    forEachNeighbour(*grid_, lost, [this, lost](Cell neighbour, std::size_t) {
+      if (step_[neighbour] != kNoStep && applyMove(*grid_, neighbour, step_[neighbour]) == lost) {
+        invalidate(neighbour);
+      }
+    });
+  }
+
+  // Re-run Dijkstra from the cells still holding a cost next to the dropped
+  // ones and around every changed cell: that refills the dropped cells and
+  // lowers whatever a newly opened cell or corner makes shorter.
+  seeds_.clear();
+  const auto seed = [this](Cell cell, std::size_t) {
+    if (cost_[cell] != kUnreachable) {
+      seeds_.push_back({cost_[cell], cell});
+    }
+  };
+  for (const Cell cell : invalid_) {
+    forEachNeighbour(*grid_, cell, seed);
+  }
+  for (const Cell cell : changed) {
+    seed(cell, 0);
+    forEachNeighbour(*grid_, cell, seed);
+  }
+  propagate();
 }
 
-bool PathFollower::isFinished() const {
-  return current_ >= nodes_.size();
+sf::Vector2f FlowField::direction(const sf::Vector2f& position) const {
+  if (grid_ == nullptr) {
+    return {};
+  }
+  const Cell cell = grid_->cellAt(position);
+  if (cell == NavGrid::kNoCell || step_[cell] == kNoStep) {
+    return {};
+  }
+  const sf::Vector2f toward = grid_->center(applyMove(*grid_, cell, step_[cell])) - position;
+  const float length = std::sqrt(toward.x * toward.x + toward.y * toward.y);
+  return length > 0.0f ? toward / length : sf::Vector2f{};
 }
 
-std::size_t PathFollower::currentIndex() const {
-  return current_;
+std::uint32_t FlowField::cost(Cell cell) const {
+  return cell < cost_.size() ? cost_[cell] : kUnreachable;
 }
 
+FlowField::Cell FlowField::next(Cell cell) const {
+  if (cell >= step_.size() || step_[cell] == kNoStep) {
+    return NavGrid::kNoCell;
+  }
+  return applyMove(*grid_, cell, step_[cell]);
+}
+
+std::size_t FlowField::lastSettled() const {
+  return settled_;
+}
+
+void FlowField::rebuild() {
+  cost_.assign(grid_->cellCount(), kUnreachable);
+  step_.assign(grid_->cellCount(), kNoStep);
+  goals_.clear();
+  seeds_.clear();
+  // A Dijkstra front on a grid stays around its perimeter in size; reserving
+  // that up front spares a fresh field a chain of reallocations.
+  for (auto& bucket : buckets_) {
+    bucket.reserve(2 * (static_cast<std::size_t>(grid_->width()) + grid_->height()));
+  }
+  for (const sf::Vector2f& position : goalPositions_) {
+    const Cell cell = grid_->nearestWalkable(grid_->cellAt(position));
+    goals_.push_back(cell);
+    if (cell != NavGrid::kNoCell) {
+      cost_[cell] = 0;
+      seeds_.push_back({0, cell});
+    }
+  }
+  propagate();
+}
+
+void FlowField::invalidate(Cell cell) {
+  cost_[cell] = kUnreachable;
+  step_[cell] = kNoStep;
+  invalid_.push_back(cell);
+}
+
+bool FlowField::stepLegal(Cell cell) const {
+  return grid_->walkable(cell) && canMove(*grid_, cell, step_[cell]);
+}
+
+void FlowField::propagate() {
+  settled_ = 0;
+  std::sort(seeds_.begin(), seeds_.end(), [](const Seed& a, const Seed& b) {
+    return a.cost < b.cost || (a.cost == b.cost && a.cell < b.cell);
+  });
+  seeds_.erase(std::unique(seeds_.begin(), seeds_.end(),
+                           [](const Seed& a, const Seed& b) { return a.cell == b.cell; }),
+               seeds_.end());
+  if (seeds_.empty()) {
+    return;
+  }
+
+  // Seeds join the ring when the sweep reaches their cost, which keeps every
+  // pending entry within the 8 costs the ring can tell apart.
+  std::size_t pending = 0;
+  std::size_t nextSeed = 0;
+  std::uint32_t current = seeds_.front().cost;
+  while (pending > 0 || nextSeed < seeds_.size()) {
+    if (pending == 0) {
+      current = std::max(current, seeds_[nextSeed].cost);
+    }
+    auto& bucket = buckets_[current % buckets_.size()];
+    for (; nextSeed < seeds_.size() && seeds_[nextSeed].cost == current; ++nextSeed) {
+      bucket.push_back(seeds_[nextSeed].cell);
+      ++pending;
+    }
+    // Moves cost at least 5, so relaxing never appends to this bucket.
+    for (const Cell cell : bucket) {
+      // Superseded entries stay queued instead of being removed.
+      if (cost_[cell] != current) {
+        continue;
+      }
+      ++settled_;
+      forEachMove(*grid_, cell, [&](Cell neighbour, std::size_t move) {
+        const std::uint32_t cost = current + (isDiagonal(move) ? kDiagonalCost : kStraightCost);
+        if (cost < cost_[neighbour]) {
+          cost_[neighbour] = cost;
+          step_[neighbour] = static_cast<std::uint8_t>(kMoves.size() - 1 - move);
+          buckets_[cost % buckets_.size()].push_back(neighbour);
+          ++pending;
+        }
+      });
+    }
+    pending -= bucket.size();
+    bucket.clear();
+    ++current;
+  }
+}
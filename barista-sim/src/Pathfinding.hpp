@@ -1,21 +1,227 @@
 #pragma once
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
-class PathFollower {
+// Walkability grid over a scene area, baked from collider boxes for one agent
+// size. A cell is blocked when the agent's box, centred anywhere inside the
+// cell, would overlap a collider; so an agent whose centre only crosses
+// walkable cells never collides.
+class NavGrid {
  public:
-  void setPath(std::vector<sf::Vector2f> nodes);
-  void setSpeed(float speed);
-  void reset();
+  using Cell = std::uint32_t;
+  static constexpr Cell kNoCell = ~Cell{0};
 
-  void update(float dt, sf::Vector2f& position);
-  [[nodiscard]] bool isFinished() const;
-  [[nodiscard]] std::size_t currentIndex() const;
+  // Re-baking over the same area and cell size records which cells flipped,
+  // so flow fields can repair just those (see FlowField::update).
+  void bake(const sf::FloatRect& area, float cellSize, std::span<const sf::FloatRect> colliders,
+            const sf::Vector2f& agentHalfSize);
+
+  // True when the last bake() changed the area or cell size; changedCells()
+  // is then empty.
+  [[nodiscard]] bool layoutChanged() const;
+  // Cells whose walkability flipped in the last bake(), in ascending order.
+  [[nodiscard]] std::span<const Cell> changedCells() const;
+
+  [[nodiscard]] std::uint32_t width() const;
+  [[nodiscard]] std::uint32_t height() const;
+  [[nodiscard]] std::size_t cellCount() const;
+  [[nodiscard]] float cellSize() const;
+
+  // kNoCell when point lies outside the baked area.
+  [[nodiscard]] Cell cellAt(const sf::Vector2f& point) const;
+  [[nodiscard]] sf::Vector2f center(Cell cell) const;
+  [[nodiscard]] bool walkable(Cell cell) const;
+  // Closest walkable cell to cell (itself when walkable), kNoCell if none.
+  [[nodiscard]] Cell nearestWalkable(Cell cell) const;
+  // True when every cell the segment touches is walkable.
+  [[nodiscard]] bool visible(const sf::Vector2f& from, const sf::Vector2f& to) const;
+
+ private:
+  [[nodiscard]] bool walkableAt(std::int64_t x, std::int64_t y) const;
+
+  sf::Vector2f origin_{};
+  float cellSize_{1.0f};
+  std::uint32_t width_{0};
+  std::uint32_t height_{0};
+  std::vector<std::uint8_t> blocked_;
+  std::vector<std::uint8_t> previous_;
+  std::vector<Cell> changed_;
+  bool layoutChanged_{false};
+};
+
+// A* over a NavGrid with 8-way moves (no cutting past blocked corners) and an
+// octile heuristic. Per-cell state lives in arrays sized to the grid and
+// reused across searches, reset lazily by a search stamp; the open set is a
+// binary heap over a vector that keeps its capacity. Solved paths are pulled
+// straight wherever the grid has line of sight.
+class GridPathSolver {
+ public:
+  using Cell = NavGrid::Cell;
+
+  // Replaces path with waypoints after start up to goal's centre. Returns
+  // false (and leaves path empty) when goal is unreachable.
+  bool solve(const NavGrid& grid, Cell start, Cell goal, std::vector<sf::Vector2f>& path);
+
+  // Cells expanded by the last solve(), for profiling.
+  [[nodiscard]] std::size_t lastExpanded() const;
 
  private:
-  std::vector<sf::Vector2f> nodes_;
-  std::size_t current_{0};
-  float speed_{60.0f};
+  struct OpenEntry {
+    float f;
+    Cell cell;
+  };
+
+  void prepare(const NavGrid& grid);
+  void buildPath(const NavGrid& grid, Cell start, Cell goal, std::vector<sf::Vector2f>& path);
+
+  std::vector<float> cost_;
+  std::vector<Cell> parent_;
+  std::vector<std::uint32_t> seen_;
+  std::vector<std::uint32_t> closed_;
+  std::uint32_t stamp_{0};
+  std::vector<OpenEntry> open_;
+  std::vector<Cell> cells_;
+  std::size_t expanded_{0};
 };
 
+// Fixed-capacity least-recently-used map from (start, goal) cell pairs to
+// solved paths, including failed searches. Path storage is reused on
+// eviction.
+class PathCache {
+ public:
+  using Cell = NavGrid::Cell;
+
+  struct Entry {
+    bool found{false};
+    std::vector<sf::Vector2f> path;
+  };
+
+  explicit PathCache(std::size_t capacity = 64);
+
+  // Returns the entry and marks it most recently used, or null on a miss.
+  [[nodiscard]] const Entry* find(Cell start, Cell goal);
+  // Returns a cleared entry for the pair, evicting the least recently used
+  // one when full.
+  Entry& insert(Cell start, Cell goal);
+  void clear();
+
+  [[nodiscard]] std::size_t size() const;
+
+ private:
+  static constexpr std::uint32_t kNone = ~std::uint32_t{0};
+
+  struct Slot {
+    std::uint64_t key{0};
+    std::uint32_t newer{kNone};
+    std::uint32_t older{kNone};
+    Entry entry;
+  };
+
+  void unlink(std::uint32_t slot);
+  void pushNewest(std::uint32_t slot);
+
+  std::size_t capacity_;
+  std::vector<Slot> slots_;
+  std::unordered_map<std::uint64_t, std::uint32_t> lookup_;
+  std::uint32_t newest_{kNone};
+  std::uint32_t oldest_{kNone};
+};
+
+// Solver and cache for one agent size: routes between world positions around
+// the colliders a NavGrid was baked from. The grid lives elsewhere, so scenes
+// sharing one layout each keep their own cache on the same grid.
+class Pathfinder {
+ public:
+  explicit Pathfinder(std::size_t cacheCapacity = 64);
+
+  // Routes over grid, which must outlive the pathfinder, and drops every
+  // cached path. Call again after re-baking the grid.
+  void setGrid(const NavGrid& grid);
+
+  // Replaces path with waypoints from `from` to `to`, ending on `to` itself
+  // when it is walkable or on the nearest walkable cell otherwise. Returns
+  // false when there is no grid, either end is outside it or no route
+  // exists.
+  bool findPath(const sf::Vector2f& from, const sf::Vector2f& to, std::vector<sf::Vector2f>& path);
+
+  [[nodiscard]] std::size_t cacheHits() const;
+  [[nodiscard]] std::size_t cacheMisses() const;
+
+ private:
+  const NavGrid* grid_{nullptr};
+  GridPathSolver solver_;
+  PathCache cache_;
+  std::size_t hits_{0};
+  std::size_t misses_{0};
+};
+
+// Distance-to-goal field over a NavGrid, shared by every agent heading for
+// the same goals. build() runs one Dijkstra pass out from the goal cells
+// (the integration field) and records for each cell the neighbour one step
+// closer (the direction field), with the solver's move rules. Agents then
+// steer by looking up their own cell, so the cost per agent is O(1) however
+// many share the field. Costs are integers, 5 per straight step and 7 per
+// diagonal, which lets the pass use a bucket queue instead of a heap.
+//
+// When colliders change, re-bake the grid and call update(): only cells whose
+// route ran through a changed cell are recomputed, plus whatever a newly
+// opened cell makes shorter.
+class FlowField {
+ public:
+  using Cell = NavGrid::Cell;
+  static constexpr std::uint32_t kUnreachable = ~std::uint32_t{0};
+
+  // Integrates the field towards the walkable cells nearest to goals. The
+  // grid must outlive the field.
+  void build(const NavGrid& grid, std::span<const sf::Vector2f> goals);
+  // Brings the field up to date after a bake() of its grid. Call after every
+  // bake; a bake that changed the layout or moved a goal cell rebuilds.
+  void update();
+
+  // Unit vector from position towards the centre of the next cell on its
+  // way to a goal; zero in a goal cell, an unreachable cell or off the grid.
+  [[nodiscard]] sf::Vector2f direction(const sf::Vector2f& position) const;
+  // Integration value of cell, kUnreachable when no goal can be reached.
+  [[nodiscard]] std::uint32_t cost(Cell cell) const;
+  // The neighbour one step closer to a goal, kNoCell at goals and unreachable
+  // cells.
+  [[nodiscard]] Cell next(Cell cell) const;
+
+  // Cells settled by the last build() or update(), for profiling.
+  [[nodiscard]] std::size_t lastSettled() const;
+
+ private:
+  static constexpr std::uint8_t kNoStep = 8;
+
+  struct Seed {
+    std::uint32_t cost;
+    Cell cell;
+  };
+
+  void rebuild();
+  void invalidate(Cell cell);
+  // False once the grid forbids the move stored for cell.
+  [[nodiscard]] bool stepLegal(Cell cell) const;
+  // Dijkstra from seeds_ (their costs already stored in cost_).
+  void propagate();
+
+  const NavGrid* grid_{nullptr};
+  std::vector<sf::Vector2f> goalPositions_;
+  std::vector<Cell> goals_;
+  std::vector<std::uint32_t> cost_;
+  // Index into the move table (see Pathfinding.cpp), kNoStep for none.
+  std::vector<std::uint8_t> step_;
+  std::vector<Cell> invalid_;
+  std::vector<Seed> seeds_;
+  // Ring of buckets by cost; moves cost at most 7, so 8 cover every cost
+  // pending at once.
+  std::array<std::vector<Cell>, 8> buckets_;
+  std::size_t settled_{0};
+};
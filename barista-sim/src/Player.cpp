@@ -1,17 +1,34 @@
 #include "Player.hpp"
 
 #include <algorithm>
+#include <utility>
 
 #include "Audio.hpp"
+#include "Components.hpp"
 #include "Utils.hpp"
 
 #include <SFML/Window/Keyboard.hpp>
 
-Player::Player() {
+void Player::spawn(World& world, std::uint32_t sprite, const sf::Vector2f& position) {
+  world_ = &world;
+  entity_ = world.create(Transform{position, position}, Velocity{}, SpriteRef{sprite, {}},
+                         PathMotion{nullptr, 0, 0, baseSpeed_});
+  waypoints_.clear();
+  autoWalking_ = false;
+  reachedWalkTarget_ = false;
   resetStats();
 }
 
-void Player::update(float dt, const InputManager& input, AudioManager& audio) {
+EntityId Player::entity() const {
+  return entity_;
+}
+
+sf::Vector2f Player::position() const {
+  const Transform* transform = world_ != nullptr ? world_->get<Transform>(entity_) : nullptr;
+  return transform != nullptr ? transform->position : sf::Vector2f{};
+}
+
+void Player::applyInput(const InputManager& input) {
   sf::Vector2f direction{};
   if (input.isKeyDown(sf::Keyboard::W)) {
     direction.y -= 1.0f;
@@ -31,15 +48,25 @@ void Player::update(float dt, const InputManager& input, AudioManager& audio) {
     speed *= sprintMultiplier_;
   }
 
+  sf::Vector2f velocity{};
   if (direction.x != 0.0f || direction.y != 0.0f) {
-    direction = utils::normalize(direction);
-    velocity_ = direction * speed;
-  } else {
-    velocity_ = {};
+    stopWalking();
+    velocity = utils::normalize(direction) * speed;
+  }
+  if (Velocity* component = world_ != nullptr ? world_->get<Velocity>(entity_) : nullptr) {
+    component->value = velocity;
   }
-
   lastPosition_ = position();
-  Entity::update(dt);
+}
+
+void Player::afterMove(float dt, AudioManager& audio) {
+  if (autoWalking_) {
+    const PathMotion* walk = world_->get<PathMotion>(entity_);
+    if (walk == nullptr || walk->cursor >= walk->count) {
+      autoWalking_ = false;
+      reachedWalkTarget_ = true;
+    }
+  }
 
   const float moved = utils::distance(position(), lastPosition_);
   lastMovement_ = moved;
@@ -48,7 +75,7 @@ void Player::update(float dt, const InputManager& input, AudioManager& audio) {
     stepTimer_ += dt;
     if (stepTimer_ >= 0.35f) {
       steps_ += 1;
-      audio.playSound("step", 35.0f);
+      audio.playSound(SoundId::Step, 35.0f);
       stepTimer_ = 0.0f;
     }
   } else {
@@ -77,9 +104,38 @@ void Player::resetStats() {
 }
 
 void Player::revertPosition(const sf::Vector2f& position) {
-  Entity::setPosition(position);
+  // A teleport: the previous-tick position is reset too, so the jump is not
+  // interpolated.
+  if (Transform* transform = world_ != nullptr ? world_->get<Transform>(entity_) : nullptr) {
+    *transform = {position, position};
+  }
   distanceTraveled_ = std::max(0.0f, distanceTraveled_ - lastMovement_);
   lastMovement_ = 0.0f;
   lastPosition_ = position;
+  stopWalking();
+}
+
+void Player::walkPath(std::vector<sf::Vector2f> waypoints) {
+  waypoints_ = std::move(waypoints);
+  autoWalking_ = !waypoints_.empty();
+  reachedWalkTarget_ = false;
+  if (PathMotion* walk = world_ != nullptr ? world_->get<PathMotion>(entity_) : nullptr) {
+    *walk = {waypoints_.data(), static_cast<std::uint32_t>(waypoints_.size()), 0, baseSpeed_};
+  }
+}
+
+void Player::stopWalking() {
+  autoWalking_ = false;
+  reachedWalkTarget_ = false;
+  if (PathMotion* walk = world_ != nullptr ? world_->get<PathMotion>(entity_) : nullptr) {
+    walk->cursor = walk->count;
+  }
 }
 
+bool Player::isAutoWalking() const {
+  return autoWalking_;
+}
+
+bool Player::reachedWalkTarget() const {
+  return reachedWalkTarget_;
+}
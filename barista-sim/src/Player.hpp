@@ -1,16 +1,29 @@
 #pragma once
 
-#include "Entity.hpp"
+#include "Ecs.hpp"
 #include "Input.hpp"
 
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+
 class AudioManager;
 
-class Player : public Entity {
+// Steers the player's World entity: turns input into its Velocity, drives
+// its PathMotion for walks, and keeps the distance and step stats. The
+// movement systems do the actual moving between applyInput() and afterMove().
+class Player {
  public:
-  Player();
+  // Creates the player's entity (Transform, Velocity, SpriteRef, PathMotion)
+  // in world, which must outlive the player or the next spawn().
+  void spawn(World& world, std::uint32_t sprite, const sf::Vector2f& position);
+  [[nodiscard]] EntityId entity() const;
+  [[nodiscard]] sf::Vector2f position() const;
 
-  using Entity::update;
-  void update(float dt, const InputManager& input, AudioManager& audio);
+  // Call before the movement systems; any movement key cancels a walk.
+  void applyInput(const InputManager& input);
+  // Call after them: counts distance and steps and notices a finished walk.
+  void afterMove(float dt, AudioManager& audio);
 
   [[nodiscard]] float interactionRadius() const;
   [[nodiscard]] float distanceTraveled() const;
@@ -19,15 +32,30 @@ class Player : public Entity {
   void resetStats();
   void revertPosition(const sf::Vector2f& position);
 
+  // Walks the waypoints on its own until they run out, a movement key is
+  // pressed or a collision blocks the way.
+  void walkPath(std::vector<sf::Vector2f> waypoints);
+  void stopWalking();
+  [[nodiscard]] bool isAutoWalking() const;
+  // True once the last walkPath() reached its final waypoint.
+  [[nodiscard]] bool reachedWalkTarget() const;
+
  private:
   float baseSpeed_{180.0f};
   float sprintMultiplier_{1.35f};
   float interactionRadius_{96.0f};
 
+  World* world_{nullptr};
+  EntityId entity_{};
+
   float distanceTraveled_{0.0f};
   unsigned steps_{0};
   float stepTimer_{0.0f};
   sf::Vector2f lastPosition_{};
   float lastMovement_{0.0f};
-};
 
+  // The entity's PathMotion points into waypoints_.
+  std::vector<sf::Vector2f> waypoints_;
+  bool autoWalking_{false};
+  bool reachedWalkTarget_{false};
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+
+// Small, fast random number generator (PCG32: 64-bit LCG state, permuted
+// 32-bit output). Each generator is a value owned by whoever draws from it,
+// so there is no shared state between threads and a seed replays exactly.
+//
+// A generator can hand out more: stream(id) derives an independent sequence
+// without advancing the parent, so one per entity gives every entity the same
+// numbers however the work is split up, and split() draws a fresh child,
+// e.g. for a subsystem. Satisfies UniformRandomBitGenerator for <random>.
+class Random {
+ public:
+  using result_type = std::uint32_t;
+
+  explicit Random(std::uint64_t seed = 0, std::uint64_t stream = 0) {
+    increment_ = (stream << 1) | 1;
+    next();
+    state_ += seed;
+    next();
+  }
+
+  // Sequence `id` of this generator, independent of every other id.
+  [[nodiscard]] Random stream(std::uint64_t id) const {
+    return Random(mix(state_ ^ mix(id)), mix(increment_ + id));
+  }
+
+  // An independent child generator; advances this one. The draws are
+  // sequenced one per statement, so every compiler splits the same way.
+  [[nodiscard]] Random split() {
+    const std::uint64_t seedHigh = next();
+    const std::uint64_t seedLow = next();
+    const std::uint64_t streamHigh = next();
+    const std::uint64_t streamLow = next();
+    return Random((seedHigh << 32) | seedLow, (streamHigh << 32) | streamLow);
+  }
+
+  std::uint32_t next() {
+    const std::uint64_t old = state_;
+    state_ = old * 6364136223846793005ULL + increment_;
+    const auto shifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+    const auto rotation = static_cast<std::uint32_t>(old >> 59);
+    return (shifted >> rotation) | (shifted << ((0U - rotation) & 31));
+  }
+
+  // Uniform in [0, 1), from the top 24 bits.
+  float uniform() {
+    return static_cast<float>(next() >> 8) * 0x1.0p-24f;
+  }
+
+  float uniform(float min, float max) {
+    return min + (max - min) * uniform();
+  }
+
+  // Fills out with uniform values in [min, max).
+  void fill(std::span<float> out, float min = 0.0f, float max = 1.0f) {
+    const float scale = (max - min) * 0x1.0p-24f;
+    for (float& value : out) {
+      value = min + static_cast<float>(next() >> 8) * scale;
+    }
+  }
+
+  result_type operator()() {
+    return next();
+  }
+  static constexpr result_type min() {
+    return 0;
+  }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+ private:
+  // SplitMix64 finalizer: spreads nearby ids across the whole state space.
+  static constexpr std::uint64_t mix(std::uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+  }
+
+  std::uint64_t state_{0};
+  std::uint64_t increment_{1};
+};
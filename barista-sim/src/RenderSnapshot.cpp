@@ -0,0 +1,170 @@
+#include "RenderSnapshot.hpp"
+
+void RenderSnapshot::clear() {
+  items_.clear();
+  sprites_.clear();
+  rectangleCount_ = 0;
+  textCount_ = 0;
+  typewriterCount_ = 0;
+  batchCount_ = 0;
+  layers_.clear();
+}
+
+void RenderSnapshot::add(const sf::Sprite& sprite) {
+  items_.push_back({Kind::Sprite, static_cast<std::uint32_t>(sprites_.size())});
+  sprites_.push_back(sprite);
+}
+
+void RenderSnapshot::add(const sf::Text& text) {
+  if (textCount_ == texts_.size()) {
+    texts_.emplace_back();
+  }
+  TextItem& item = texts_[textCount_];
+  item.font = text.getFont();
+  item.string = text.getString();
+  item.characterSize = text.getCharacterSize();
+  item.style = text.getStyle();
+  item.fillColor = text.getFillColor();
+  item.transform = text;
+  items_.push_back({Kind::Text, static_cast<std::uint32_t>(textCount_++)});
+}
+
+void RenderSnapshot::add(const sf::RectangleShape& shape) {
+  if (rectangleCount_ == rectangles_.size()) {
+    rectangles_.push_back(shape);
+  } else {
+    rectangles_[rectangleCount_] = shape;
+  }
+  items_.push_back({Kind::Rectangle, static_cast<std::uint32_t>(rectangleCount_++)});
+}
+
+void RenderSnapshot::add(const TypewriterText& text) {
+  if (typewriterCount_ == typewriters_.size()) {
+    typewriters_.emplace_back();
+  }
+  TypewriterItem& item = typewriters_[typewriterCount_];
+  if (item.revision != text.revision()) {
+    item.revision = text.revision();
+    item.font = text.getFont();
+    item.string = text.getString();
+    item.characterSize = text.getCharacterSize();
+    item.wrapWidth = text.getWrapWidth();
+  }
+  item.visibleGlyphs = text.visibleGlyphs();
+  item.fillColor = text.getFillColor();
+  item.transform = text;
+  items_.push_back({Kind::Typewriter, static_cast<std::uint32_t>(typewriterCount_++)});
+}
+
+SpriteBatch& RenderSnapshot::addBatch() {
+  if (batchCount_ == batches_.size()) {
+    batches_.emplace_back();
+  }
+  SpriteBatch& batch = batches_[batchCount_];
+  batch.clear();
+  items_.push_back({Kind::Batch, static_cast<std::uint32_t>(batchCount_++)});
+  return batch;
+}
+
+void RenderSnapshot::beginLayer(const sf::FloatRect& area, std::uint64_t revision) {
+  items_.push_back({Kind::Layer, static_cast<std::uint32_t>(layers_.size())});
+  layers_.push_back({area, revision, 0});
+}
+
+void RenderSnapshot::endLayer() {
+  // The layer's own item is the last Layer item in items_.
+  std::uint32_t count = 0;
+  for (auto item = items_.rbegin(); item != items_.rend() && item->kind != Kind::Layer; ++item) {
+    ++count;
+  }
+  layers_.back().itemCount = count;
+}
+
+bool RenderSnapshot::empty() const {
+  return items_.empty();
+}
+
+void SnapshotRenderer::draw(sf::RenderTarget& target, const RenderSnapshot& snapshot) {
+  if (texts_.size() < snapshot.textCount_) {
+    texts_.resize(snapshot.textCount_);
+  }
+  if (typewriters_.size() < snapshot.typewriterCount_) {
+    typewriters_.resize(snapshot.typewriterCount_);
+  }
+  if (layers_.size() < snapshot.layers_.size()) {
+    layers_.resize(snapshot.layers_.size());
+  }
+  drawItems(target, snapshot, 0, snapshot.items_.size());
+}
+
+void SnapshotRenderer::drawItems(sf::RenderTarget& target, const RenderSnapshot& snapshot,
+                                 std::size_t begin, std::size_t end) {
+  for (std::size_t i = begin; i < end; ++i) {
+    const auto& item = snapshot.items_[i];
+    switch (item.kind) {
+      case RenderSnapshot::Kind::Sprite:
+        target.draw(snapshot.sprites_[item.index]);
+        break;
+      case RenderSnapshot::Kind::Rectangle:
+        target.draw(snapshot.rectangles_[item.index]);
+        break;
+      case RenderSnapshot::Kind::Text: {
+        const auto& source = snapshot.texts_[item.index];
+        if (!source.font) {
+          break;
+        }
+        // Setters are no-ops when the value is unchanged, so an unchanged
+        // slot keeps its cached glyph geometry.
+        sf::Text& text = texts_[item.index];
+        text.setFont(*source.font);
+        text.setCharacterSize(source.characterSize);
+        text.setStyle(source.style);
+        text.setString(source.string);
+        text.setFillColor(source.fillColor);
+        text.setPosition(source.transform.getPosition());
+        text.setOrigin(source.transform.getOrigin());
+        text.setScale(source.transform.getScale());
+        text.setRotation(source.transform.getRotation());
+        target.draw(text);
+        break;
+      }
+      case RenderSnapshot::Kind::Typewriter: {
+        const auto& source = snapshot.typewriters_[item.index];
+        if (!source.font) {
+          break;
+        }
+        TypewriterSlot& slot = typewriters_[item.index];
+        if (slot.sourceRevision != source.revision) {
+          slot.sourceRevision = source.revision;
+          slot.text.setFont(*source.font);
+          slot.text.setCharacterSize(source.characterSize);
+          slot.text.setWrapWidth(source.wrapWidth);
+          slot.text.setString(source.string);
+        }
+        slot.text.setVisibleGlyphs(source.visibleGlyphs);
+        slot.text.setFillColor(source.fillColor);
+        slot.text.setPosition(source.transform.getPosition());
+        slot.text.setOrigin(source.transform.getOrigin());
+        slot.text.setScale(source.transform.getScale());
+        slot.text.setRotation(source.transform.getRotation());
+        target.draw(slot.text);
+        break;
+      }
+      case RenderSnapshot::Kind::Batch:
+        target.draw(snapshot.batches_[item.index]);
+        break;
+      case RenderSnapshot::Kind::Layer: {
+        const auto& source = snapshot.layers_[item.index];
+        const std::size_t first = i + 1;
+        const std::size_t last = first + source.itemCount;
+        StaticLayer& layer = layers_[item.index];
+        layer.setArea(source.area);
+        layer.draw(target, source.revision, [&](sf::RenderTarget& content) {
+          drawItems(content, snapshot, first, last);
+        });
+        i = last - 1;
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SpriteBatch.hpp"
+#include "StaticLayer.hpp"
+#include "TypewriterText.hpp"
+
+// Immutable copy of everything a scene draws in one frame, produced on the
+// simulation thread and consumed by SnapshotRenderer on the render thread.
+// Only plain data is copied: textures and fonts are referenced, never owned,
+// and storage is reused between frames so steady-state captures don't
+// allocate.
+class RenderSnapshot {
+ public:
+  void clear();
+
+  void add(const sf::Sprite& sprite);
+  void add(const sf::Text& text);
+  void add(const sf::RectangleShape& shape);
+  // The string is only copied when the source's layout revision changed
+  // since this slot last captured it.
+  void add(const TypewriterText& text);
+  // Appends a pooled, cleared batch to fill; it is drawn at this position in
+  // the item order.
+  SpriteBatch& addBatch();
+  // Items added until endLayer() make up a StaticLayer over area: the
+  // renderer composites them again only when revision changes, and
+  // otherwise draws its cached copy. Layers don't nest.
+  void beginLayer(const sf::FloatRect& area, std::uint64_t revision);
+  void endLayer();
+
+  [[nodiscard]] bool empty() const;
+
+ private:
+  friend class SnapshotRenderer;
+
+  enum class Kind : std::uint8_t { Sprite, Text, Rectangle, Typewriter, Batch, Layer };
+
+  struct Item {
+    Kind kind;
+    std::uint32_t index;
+  };
+
+  struct TextItem {
+    const sf::Font* font{nullptr};
+    sf::String string;
+    unsigned characterSize{30};
+    std::uint32_t style{sf::Text::Regular};
+    sf::Color fillColor;
+    sf::Transformable transform;
+  };
+
+  struct TypewriterItem {
+    std::uint64_t revision{0};
+    const sf::Font* font{nullptr};
+    sf::String string;
+    unsigned characterSize{30};
+    float wrapWidth{0.0f};
+    std::size_t visibleGlyphs{0};
+    sf::Color fillColor;
+    sf::Transformable transform;
+  };
+
+  struct LayerItem {
+    sf::FloatRect area;
+    std::uint64_t revision{0};
+    // Items after this one that belong to the layer.
+    std::uint32_t itemCount{0};
+  };
+
+  std::vector<Item> items_;
+  std::vector<sf::Sprite> sprites_;
+  std::vector<sf::RectangleShape> rectangles_;
+  std::vector<TextItem> texts_;
+  std::vector<TypewriterItem> typewriters_;
+  std::vector<SpriteBatch> batches_;
+  std::vector<LayerItem> layers_;
+  std::size_t rectangleCount_{0};
+  std::size_t textCount_{0};
+  std::size_t typewriterCount_{0};
+  std::size_t batchCount_{0};
+};
+
+// Render-thread side of a snapshot. Keeps one persistent sf::Text or
+// TypewriterText per text slot so glyph geometry is only rebuilt when a
+// slot's content changes, and one StaticLayer per layer slot.
+class SnapshotRenderer {
+ public:
+  void draw(sf::RenderTarget& target, const RenderSnapshot& snapshot);
+
+ private:
+  // Draws items [begin, end) of the snapshot.
+  void drawItems(sf::RenderTarget& target, const RenderSnapshot& snapshot, std::size_t begin,
+                 std::size_t end);
+
+  struct TypewriterSlot {
+    TypewriterText text;
+    std::uint64_t sourceRevision{0};
+  };
+
+  std::vector<sf::Text> texts_;
+  std::vector<TypewriterSlot> typewriters_;
+  std::vector<StaticLayer> layers_;
+};
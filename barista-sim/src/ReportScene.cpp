@@ -4,33 +4,34 @@
 #include <iomanip>
 #include <sstream>
 
-#include "App.hpp"
+#include "Audio.hpp"
+#include "RenderSnapshot.hpp"
 #include "Resources.hpp"
 
-ReportScene::ReportScene(App& app, SceneContext context, OrderReport report)
-    : Scene(app, context), report_(std::move(report)) {
+ReportScene::ReportScene(SceneHost& host, SceneContext context, OrderReport report)
+    : Scene(host, context), report_(std::move(report)) {
   buildUI();
 }
 
 void ReportScene::onEnter() {
-  context().audio.playSound("ding", 60.0f);
+  context().audio.playSound(SoundId::Ding, 60.0f);
 }
 
 void ReportScene::handleEvent(const sf::Event& event) {
 #if SFML_VERSION_MAJOR >= 3
   if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
     if (key->code == sf::Keyboard::Enter || key->code == sf::Keyboard::Space) {
-      app().restartSimulation();
+      host().restartSimulation();
     } else if (key->code == sf::Keyboard::Escape) {
-      app().window().close();
+      host().requestQuit();
     }
   }
 #else
   if (event.type == sf::Event::KeyPressed) {
     if (event.key.code == sf::Keyboard::Enter || event.key.code == sf::Keyboard::Space) {
-      app().restartSimulation();
+      host().restartSimulation();
     } else if (event.key.code == sf::Keyboard::Escape) {
-      app().window().close();
+      host().requestQuit();
     }
   }
 #endif
@@ -40,7 +41,7 @@ void ReportScene::update(float /*dt*/) {
   // No animated elements yet.
 }
 
-void ReportScene::draw(sf::RenderTarget& target) {
+void ReportScene::draw(sf::RenderTarget& target, float /*alpha*/) {
   target.draw(backdrop_);
   target.draw(titleText_);
   target.draw(statsText_);
@@ -48,9 +49,17 @@ void ReportScene::draw(sf::RenderTarget& target) {
   target.draw(promptText_);
 }
 
+void ReportScene::capture(RenderSnapshot& snapshot) const {
+  snapshot.add(backdrop_);
+  snapshot.add(titleText_);
+  snapshot.add(statsText_);
+  snapshot.add(tipText_);
+  snapshot.add(promptText_);
+}
+
 void ReportScene::buildUI() {
   auto& resources = context().resources;
-  const auto& font = resources.font("ui");
+  const auto& font = resources.font(FontId::Ui);
 
   backdrop_.setSize({800.0f, 420.0f});
   backdrop_.setFillColor(sf::Color(20, 20, 30, 240));
@@ -72,14 +81,8 @@ void ReportScene::buildUI() {
   stats << "Steps taken: " << report_.steps << "\n";
   stats << "Order complete: " << (report_.complete ? "Yes" : "No");
 
-  if (!report_.missingFields.empty()) {
-    stats << "\nMissing: ";
-    for (std::size_t i = 0; i < report_.missingFields.size(); ++i) {
-      stats << report_.missingFields[i];
-      if (i + 1 < report_.missingFields.size()) {
-        stats << ", ";
-      }
-    }
+  if (report_.missingFields != 0) {
+    stats << "\nMissing: " << describeOrderFields(report_.missingFields);
   }
 
   statsText_.setFont(font);
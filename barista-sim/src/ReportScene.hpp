@@ -1,28 +1,37 @@
 #pragma once
 
+#include "Order.hpp"
 #include "Scene.hpp"
 
 #include <SFML/Graphics.hpp>
 #include <string>
-#include <vector>
 
 struct OrderReport {
+  // Includes penaltySeconds.
   float timeSeconds{0.0f};
+  // Added for letting the queue wait at the counter.
+  float penaltySeconds{0.0f};
   float pathDistance{0.0f};
   unsigned steps{0};
   bool complete{false};
-  std::vector<std::string> missingFields;
+  // Bits of the fields still missing; names are only built for display.
+  OrderFieldMask missingFields{0};
+  // The order as taken and the fields the scenario asked for, so batches
+  // can re-check orders together (see SessionAnalytics).
+  Order order;
+  OrderFieldMask requiredFields{kAllOrderFields};
   std::string tip;
 };
 
 class ReportScene : public Scene {
  public:
-  ReportScene(App& app, SceneContext context, OrderReport report);
+  ReportScene(SceneHost& host, SceneContext context, OrderReport report);
 
   void onEnter() override;
   void handleEvent(const sf::Event& event) override;
   void update(float dt) override;
-  void draw(sf::RenderTarget& target) override;
+  void draw(sf::RenderTarget& target, float alpha) override;
+  void capture(RenderSnapshot& snapshot) const override;
 
  private:
   void buildUI();
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Every asset the game ships is known at compile time, so resources are
+// addressed by enum handles that index straight into dense arrays. Strings
+// only appear in the manifest (file paths) and in error messages.
+
+enum class TextureId : std::uint8_t { CafeBackground, Player, Barista, Customer, UiPanel, Count };
+enum class FontId : std::uint8_t { Ui, Count };
+enum class SoundId : std::uint8_t { Ding, Step, UiClick, Count };
+// Music is streamed rather than loaded; the id only names the track.
+enum class MusicId : std::uint8_t { Ambience, Count };
+
+template <typename Id>
+[[nodiscard]] constexpr std::size_t indexOf(Id id) {
+  return static_cast<std::size_t>(id);
+}
+
+template <typename Id>
+inline constexpr std::size_t kResourceCount = indexOf(Id::Count);
+
+struct TextureAsset {
+  TextureId id;
+  std::string_view path;
+};
+
+struct FontAsset {
+  FontId id;
+  std::string_view path;
+};
+
+struct SoundAsset {
+  SoundId id;
+  std::string_view path;
+};
+
+struct MusicAsset {
+  MusicId id;
+  std::string_view path;
+};
+
+inline constexpr TextureAsset kTextureManifest[] = {
+    {TextureId::CafeBackground, "assets/textures/cafe_bg.png"},
+    {TextureId::Player, "assets/textures/player.png"},
+    {TextureId::Barista, "assets/textures/barista.png"},
+    {TextureId::Customer, "assets/textures/customer.png"},
+    {TextureId::UiPanel, "assets/textures/ui_panel.png"},
+};
+
+inline constexpr FontAsset kFontManifest[] = {
+    {FontId::Ui, "assets/fonts/ui_font.ttf"},
+};
+
+inline constexpr SoundAsset kSoundManifest[] = {
+    {SoundId::Ding, "assets/audio/ding.ogg"},
+    {SoundId::Step, "assets/audio/step.ogg"},
+    {SoundId::UiClick, "assets/audio/ui_click.ogg"},
+};
+
+inline constexpr MusicAsset kMusicManifest[] = {
+    {MusicId::Ambience, "assets/audio/ambience.ogg"},
+};
+
+// Manifest path for an id, used to name assets in error messages.
+template <typename Asset, std::size_t N, typename Id>
+[[nodiscard]] constexpr std::string_view manifestPath(const Asset (&manifest)[N], Id id) {
+  for (const auto& asset : manifest) {
+    if (asset.id == id) {
+      return asset.path;
+    }
+  }
+  return "<unknown>";
+}
@@ -2,57 +2,131 @@
 
 #include <stdexcept>
 
-void ResourceManager::loadTexture(const std::string& id, const std::string& path) {
+namespace {
+template <typename Asset, std::size_t N, typename Id>
+[[noreturn]] void throwMissing(const char* kind, const Asset (&manifest)[N], Id id) {
+  throw std::runtime_error(std::string("Missing ") + kind + ": " +
+                           std::string(manifestPath(manifest, id)));
+}
+}  // namespace
+
+void ResourceManager::setGraphicsEnabled(bool enabled) {
+  graphicsEnabled_ = enabled;
+}
+
+bool ResourceManager::graphicsEnabled() const {
+  return graphicsEnabled_;
+}
+
+bool ResourceManager::mountPack(const std::string& path) {
+  pack_ = AssetPack::open(path);
+  return pack_ != nullptr;
+}
+
+const AssetPack* ResourceManager::pack() const {
+  return pack_.get();
+}
+
+void ResourceManager::loadTexture(TextureId id, const std::string& path) {
   sf::Texture texture;
-  if (!texture.loadFromFile(path)) {
-    throw std::runtime_error("Failed to load texture: " + path);
+  sf::Vector2u size;
+  if (graphicsEnabled_) {
+    if (!texture.loadFromFile(path)) {
+      throw std::runtime_error("Failed to load texture: " + path);
+    }
+    size = texture.getSize();
+  } else {
+    sf::Image image;
+    if (!image.loadFromFile(path)) {
+      throw std::runtime_error("Failed to load texture: " + path);
+    }
+    size = image.getSize();
   }
-  textures_.insert_or_assign(id, std::move(texture));
+  const std::size_t index = indexOf(id);
+  textures_[index] = std::move(texture);
+  textureSizes_[index] = size;
+  texturesLoaded_[index] = true;
+}
+
+void ResourceManager::addTexture(TextureId id, const sf::Image& image) {
+  addTexture(id, image.getPixelsPtr(), image.getSize());
 }
 
-void ResourceManager::loadFont(const std::string& id, const std::string& path) {
+void ResourceManager::addTexture(TextureId id, const std::uint8_t* rgbaPixels, sf::Vector2u size) {
+  const std::size_t index = indexOf(id);
+  if (graphicsEnabled_) {
+    sf::Texture& texture = textures_[index];
+    if (!texture.create(size.x, size.y)) {
+      throw std::runtime_error("Failed to upload texture: " +
+                               std::string(manifestPath(kTextureManifest, id)));
+    }
+    texture.update(rgbaPixels);
+  }
+  textureSizes_[index] = size;
+  texturesLoaded_[index] = true;
+}
+
+void ResourceManager::loadFont(FontId id, const std::string& path) {
   sf::Font font;
   if (!font.loadFromFile(path)) {
     throw std::runtime_error("Failed to load font: " + path);
   }
-  fonts_.insert_or_assign(id, std::move(font));
+  fonts_[indexOf(id)] = std::move(font);
+  fontsLoaded_[indexOf(id)] = true;
 }
 
-void ResourceManager::loadSoundBuffer(const std::string& id, const std::string& path) {
+void ResourceManager::loadSoundBuffer(SoundId id, const std::string& path) {
   sf::SoundBuffer buffer;
   if (!buffer.loadFromFile(path)) {
     throw std::runtime_error("Failed to load sound: " + path);
   }
-  sounds_.insert_or_assign(id, std::move(buffer));
+  sounds_[indexOf(id)] = std::move(buffer);
+  soundsLoaded_[indexOf(id)] = true;
 }
 
-const sf::Texture& ResourceManager::texture(const std::string& id) const {
-  const auto it = textures_.find(id);
-  if (it == textures_.end()) {
-    throw std::runtime_error("Missing texture: " + id);
+const sf::Texture& ResourceManager::texture(TextureId id) const {
+  if (!texturesLoaded_[indexOf(id)]) {
+    throwMissing("texture", kTextureManifest, id);
   }
-  return it->second;
+  return textures_[indexOf(id)];
 }
 
-const sf::Font& ResourceManager::font(const std::string& id) const {
-  const auto it = fonts_.find(id);
-  if (it == fonts_.end()) {
-    throw std::runtime_error("Missing font: " + id);
+sf::Vector2u ResourceManager::textureSize(TextureId id) const {
+  if (!texturesLoaded_[indexOf(id)]) {
+    throwMissing("texture", kTextureManifest, id);
   }
-  return it->second;
+  return textureSizes_[indexOf(id)];
 }
 
-const sf::SoundBuffer& ResourceManager::soundBuffer(const std::string& id) const {
-  const auto it = sounds_.find(id);
-  if (it == sounds_.end()) {
-    throw std::runtime_error("Missing sound buffer: " + id);
+const sf::Font& ResourceManager::font(FontId id) const {
+  if (!fontsLoaded_[indexOf(id)]) {
+    throwMissing("font", kFontManifest, id);
   }
-  return it->second;
+  return fonts_[indexOf(id)];
 }
 
-void ResourceManager::clear() {
-  textures_.clear();
-  fonts_.clear();
-  sounds_.clear();
+bool ResourceManager::hasFont(FontId id) const {
+  return fontsLoaded_[indexOf(id)];
 }
 
+const sf::SoundBuffer& ResourceManager::soundBuffer(SoundId id) const {
+  if (!soundsLoaded_[indexOf(id)]) {
+    throwMissing("sound buffer", kSoundManifest, id);
+  }
+  return sounds_[indexOf(id)];
+}
+
+bool ResourceManager::hasSoundBuffer(SoundId id) const {
+  return soundsLoaded_[indexOf(id)];
+}
+
+void ResourceManager::clear() {
+  textures_.fill(sf::Texture());
+  textureSizes_.fill(sf::Vector2u());
+  texturesLoaded_.fill(false);
+  fonts_.fill(sf::Font());
+  fontsLoaded_.fill(false);
+  sounds_.fill(sf::SoundBuffer());
+  soundsLoaded_.fill(false);
+  pack_.reset();
+}
@@ -2,24 +2,56 @@
 
 #include <SFML/Audio/SoundBuffer.hpp>
 #include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <unordered_map>
 
+#include "AssetPack.hpp"
+#include "ResourceIds.hpp"
+
+// Resources live in dense arrays indexed by their typed id, so lookups in
+// per-tick code are a single array index plus a loaded check.
 class ResourceManager {
  public:
-  void loadTexture(const std::string& id, const std::string& path);
-  void loadFont(const std::string& id, const std::string& path);
-  void loadSoundBuffer(const std::string& id, const std::string& path);
+  friend class AssetLoader;
+
+  // Headless runs have no GL context: textures are only probed for their
+  // size and the sf::Texture handed out stays empty.
+  void setGraphicsEnabled(bool enabled);
+  [[nodiscard]] bool graphicsEnabled() const;
+
+  // Maps a cooked pack; loaders prefer its blobs over the loose files.
+  // Returns false if the file does not exist. Fonts and music read from the
+  // mapping in place, so it stays mounted until clear().
+  bool mountPack(const std::string& path);
+  [[nodiscard]] const AssetPack* pack() const;
 
-  [[nodiscard]] const sf::Texture& texture(const std::string& id) const;
-  [[nodiscard]] const sf::Font& font(const std::string& id) const;
-  [[nodiscard]] const sf::SoundBuffer& soundBuffer(const std::string& id) const;
+  void loadTexture(TextureId id, const std::string& path);
+  void loadFont(FontId id, const std::string& path);
+  void loadSoundBuffer(SoundId id, const std::string& path);
+  // Uploads an already decoded image (or only records its size when
+  // graphics are disabled). Needs the GL context's thread.
+  void addTexture(TextureId id, const sf::Image& image);
+  void addTexture(TextureId id, const std::uint8_t* rgbaPixels, sf::Vector2u size);
+
+  [[nodiscard]] const sf::Texture& texture(TextureId id) const;
+  [[nodiscard]] sf::Vector2u textureSize(TextureId id) const;
+  [[nodiscard]] const sf::Font& font(FontId id) const;
+  [[nodiscard]] bool hasFont(FontId id) const;
+  [[nodiscard]] const sf::SoundBuffer& soundBuffer(SoundId id) const;
+  [[nodiscard]] bool hasSoundBuffer(SoundId id) const;
 
   void clear();
 
  private:
-  std::unordered_map<std::string, sf::Texture> textures_;
-  std::unordered_map<std::string, sf::Font> fonts_;
-  std::unordered_map<std::string, sf::SoundBuffer> sounds_;
+  bool graphicsEnabled_{true};
+  std::unique_ptr<AssetPack> pack_;
+  std::array<sf::Texture, kResourceCount<TextureId>> textures_;
+  std::array<sf::Vector2u, kResourceCount<TextureId>> textureSizes_{};
+  std::array<bool, kResourceCount<TextureId>> texturesLoaded_{};
+  std::array<sf::Font, kResourceCount<FontId>> fonts_;
+  std::array<bool, kResourceCount<FontId>> fontsLoaded_{};
+  std::array<sf::SoundBuffer, kResourceCount<SoundId>> sounds_;
+  std::array<bool, kResourceCount<SoundId>> soundsLoaded_{};
 };
-
@@ -1,13 +1,12 @@
 #include "Scene.hpp"
 
-Scene::Scene(App& app, SceneContext context)
-    : app_(app), context_(context) {}
+Scene::Scene(SceneHost& host, SceneContext context)
+    : host_(host), context_(context) {}
 
-App& Scene::app() {
-  return app_;
+SceneHost& Scene::host() {
+  return host_;
 }
 
 SceneContext& Scene::context() {
   return context_;
 }
-
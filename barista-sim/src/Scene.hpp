@@ -2,22 +2,47 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
+#include <cstddef>
 
-class App;
 class ResourceManager;
 class AudioManager;
+class RenderSnapshot;
 class InputManager;
+class JobSystem;
+struct OrderReport;
+
+// Default simulation tick, used by headless runs and scripts. The windowed
+// loop can run at a different rate (AppOptions::simulationHz).
+inline constexpr float kFixedTimeStep = 1.0f / 60.0f;
+
+// Customers queueing in CafeScene. Stress runs raise it (--customers=N).
+inline constexpr std::size_t kDefaultCustomerCount = 3;
+
+// Whatever owns the active scene: the windowed App or the headless runner.
+// Scenes only talk to their owner through this interface.
+class SceneHost {
+ public:
+  virtual ~SceneHost() = default;
+
+  virtual void showReport(const OrderReport& report) = 0;
+  virtual void restartSimulation() = 0;
+  virtual void requestQuit() = 0;
+};
 
 struct SceneContext {
-  sf::RenderWindow& window;
-  ResourceManager& resources;
+  sf::RenderWindow* window;  // null when running headless
+  // Read-only, so parallel headless sessions can share one.
+  const ResourceManager& resources;
   AudioManager& audio;
   InputManager& input;
+  // Worker threads for splitting up simulation work; results must not
+  // depend on how many there are.
+  JobSystem& jobs;
 };
 
 class Scene {
  public:
-  Scene(App& app, SceneContext context);
+  Scene(SceneHost& host, SceneContext context);
   virtual ~Scene() = default;
 
   virtual void onEnter() {}
@@ -25,14 +50,17 @@ class Scene {
 
   virtual void handleEvent(const sf::Event& event) = 0;
   virtual void update(float dt) = 0;
-  virtual void draw(sf::RenderTarget& target) = 0;
+  // alpha is how far the frame sits between the previous and the latest
+  // update() (0..1), for interpolating moving objects.
+  virtual void draw(sf::RenderTarget& target, float alpha) = 0;
+  // Records what draw() would render, for the pipelined render thread.
+  virtual void capture(RenderSnapshot& snapshot) const = 0;
 
  protected:
-  App& app();
+  SceneHost& host();
   SceneContext& context();
 
  private:
-  App& app_;
+  SceneHost& host_;
   SceneContext context_;
 };
-
@@ -0,0 +1,295 @@
+#include "SessionAnalytics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+#include "ReportScene.hpp"
+
+namespace {
+struct MetricInfo {
+  const char* name;
+  // Smallest difference worth telling apart.
+  double unit;
+};
+
+constexpr MetricInfo kMetrics[] = {
+    {"time_to_order_s", 0.001},
+    {"path_distance_px", 0.1},
+    {"steps", 1.0},
+    {"penalty_time_s", 0.001},
+};
+static_assert(std::size(kMetrics) == SessionAnalytics::kMetricCount);
+
+constexpr double kPercentiles[] = {0.50, 0.90, 0.95, 0.99};
+constexpr const char* kPercentileNames[] = {"p50", "p90", "p95", "p99"};
+
+[[nodiscard]] double metricValue(const OrderReport& report, std::size_t metric) {
+  switch (static_cast<SessionAnalytics::Metric>(metric)) {
+    case SessionAnalytics::Metric::TimeToOrder:
+      return report.timeSeconds;
+    case SessionAnalytics::Metric::PathDistance:
+      return report.pathDistance;
+    case SessionAnalytics::Metric::Steps:
+      return report.steps;
+    case SessionAnalytics::Metric::PenaltyTime:
+      return report.penaltySeconds;
+    case SessionAnalytics::Metric::Count:
+      break;
+  }
+  return 0.0;
+}
+}  // namespace
+
+Histogram::Histogram(double unit) : unit_(unit), counts_(kBucketCount, 0) {
+  if (!(unit > 0.0)) {
+    throw std::invalid_argument("Histogram unit must be positive");
+  }
+}
+
+void Histogram::record(double value) {
+  constexpr double kMaxUnits = static_cast<double>((std::uint64_t{1} << kMaxValueBits) - 1);
+  const double units = std::clamp(std::round(value / unit_), 0.0, kMaxUnits);
+  ++counts_[bucketOf(static_cast<std::uint64_t>(units))];
+  ++count_;
+}
+
+void Histogram::merge(const Histogram& other) {
+  if (other.unit_ != unit_) {
+    throw std::invalid_argument("Cannot merge histograms with different units");
+  }
+  for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+    counts_[bucket] += other.counts_[bucket];
+  }
+  count_ += other.count_;
+}
+
+std::uint64_t Histogram::count() const {
+  return count_;
+}
+
+double Histogram::percentile(double fraction) const {
+  if (count_ == 0) {
+    return 0.0;
+  }
+  // Nearest rank, as in FrameProfiler's summaries.
+  const auto rank = std::clamp<std::uint64_t>(
+      static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(count_))), 1, count_);
+  std::uint64_t seen = 0;
+  for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+    seen += counts_[bucket];
+    if (seen >= rank) {
+      return bucketMidpoint(bucket) * unit_;
+    }
+  }
+  return bucketMidpoint(kBucketCount - 1) * unit_;
+}
+
+double Histogram::unit() const {
+  return unit_;
+}
+
+std::size_t Histogram::bucketOf(std::uint64_t units) {
+  if (units < kSubBuckets) {
+    return static_cast<std::size_t>(units);
+  }
+  // Keep the top kSubBucketBits + 1 bits: a power-of-two range, then a
+  // linear step within it.
+  const unsigned shift = static_cast<unsigned>(std::bit_width(units)) - kSubBucketBits - 1;
+  return static_cast<std::size_t>(shift * kSubBuckets + (units >> shift));
+}
+
+double Histogram::bucketMidpoint(std::size_t bucket) {
+  if (bucket < kSubBuckets) {
+    return static_cast<double>(bucket);
+  }
+  const std::size_t shift = bucket / kSubBuckets - 1;
+  const std::uint64_t lowest = (bucket % kSubBuckets + kSubBuckets) << shift;
+  const std::uint64_t width = std::uint64_t{1} << shift;
+  return static_cast<double>(lowest) + static_cast<double>(width - 1) / 2.0;
+}
+
+void RunningStats::record(double value) {
+  ++count_;
+  const double delta = value - mean_;
+  mean_ += delta / static_cast<double>(count_);
+  m2_ += delta * (value - mean_);
+  min_ = count_ == 1 ? value : std::min(min_, value);
+  max_ = count_ == 1 ? value : std::max(max_, value);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+  if (other.count_ == 0) {
+    return;
+  }
+  if (count_ == 0) {
+    *this = other;
+    return;
+  }
+  const double total = static_cast<double>(count_ + other.count_);
+  const double delta = other.mean_ - mean_;
+  mean_ += delta * static_cast<double>(other.count_) / total;
+  m2_ += other.m2_ +
+         delta * delta * static_cast<double>(count_) * static_cast<double>(other.count_) / total;
+  count_ += other.count_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+std::uint64_t RunningStats::count() const {
+  return count_;
+}
+
+double RunningStats::mean() const {
+  return mean_;
+}
+
+double RunningStats::variance() const {
+  return count_ < 2 ? 0.0 : m2_ / static_cast<double>(count_ - 1);
+}
+
+double RunningStats::min() const {
+  return min_;
+}
+
+double RunningStats::max() const {
+  return max_;
+}
+
+SessionAnalytics::SessionAnalytics() {
+  series_.reserve(kMetricCount);
+  for (const MetricInfo& metric : kMetrics) {
+    series_.push_back({RunningStats{}, Histogram(metric.unit)});
+  }
+}
+
+void SessionAnalytics::add(const OrderReport& report) {
+  for (std::size_t metric = 0; metric < kMetricCount; ++metric) {
+    const double value = metricValue(report, metric);
+    series_[metric].stats.record(value);
+    series_[metric].histogram.record(value);
+  }
+  ++sessions_;
+  if (pendingCount_ == kOrderBatch ||
+      (pendingCount_ > 0 && report.requiredFields != pendingRequired_)) {
+    flushOrders();
+  }
+  pendingRequired_ = report.requiredFields;
+  pendingOrders_[pendingCount_++] = report.order;
+}
+
+void SessionAnalytics::flushOrders() const {
+  std::array<OrderFieldMask, kOrderBatch> missing{};
+  completed_ += validateOrders(std::span<const Order>(pendingOrders_.data(), pendingCount_),
+                               missing, pendingRequired_);
+  for (std::size_t i = 0; i < pendingCount_; ++i) {
+    for (std::size_t field = 0; field < kOrderFieldCount; ++field) {
+      const OrderFieldMask bit = orderFieldBit(static_cast<OrderField>(field));
+      missing_[field] += (missing[i] & bit) != 0 ? 1 : 0;
+    }
+  }
+  pendingCount_ = 0;
+}
+
+void SessionAnalytics::merge(const SessionAnalytics& other) {
+  flushOrders();
+  other.flushOrders();
+  for (std::size_t metric = 0; metric < kMetricCount; ++metric) {
+    series_[metric].stats.merge(other.series_[metric].stats);
+    series_[metric].histogram.merge(other.series_[metric].histogram);
+  }
+  sessions_ += other.sessions_;
+  completed_ += other.completed_;
+  for (std::size_t field = 0; field < kOrderFieldCount; ++field) {
+    missing_[field] += other.missing_[field];
+  }
+}
+
+std::uint64_t SessionAnalytics::sessions() const {
+  return sessions_;
+}
+
+std::uint64_t SessionAnalytics::completed() const {
+  flushOrders();
+  return completed_;
+}
+
+std::uint64_t SessionAnalytics::missing(OrderField field) const {
+  flushOrders();
+  return missing_[static_cast<std::size_t>(field)];
+}
+
+const RunningStats& SessionAnalytics::stats(Metric metric) const {
+  return series_[static_cast<std::size_t>(metric)].stats;
+}
+
+const Histogram& SessionAnalytics::histogram(Metric metric) const {
+  return series_[static_cast<std::size_t>(metric)].histogram;
+}
+
+void SessionAnalytics::writeCsv(std::ostream& out) const {
+  flushOrders();
+  out << std::setprecision(6);
+  out << "metric,count,mean,stddev,min,p50,p90,p95,p99,max\n";
+  for (std::size_t metric = 0; metric < kMetricCount; ++metric) {
+    const Series& series = series_[metric];
+    out << kMetrics[metric].name << ',' << series.stats.count() << ',' << series.stats.mean() << ','
+        << std::sqrt(series.stats.variance()) << ',' << series.stats.min();
+    for (const double fraction : kPercentiles) {
+      out << ',' << series.histogram.percentile(fraction);
+    }
+    out << ',' << series.stats.max() << '\n';
+  }
+  out << "\nfield,sessions,missing\n";
+  for (std::size_t field = 0; field < kOrderFieldCount; ++field) {
+    out << orderFieldName(static_cast<OrderField>(field)) << ',' << sessions_ << ','
+        << missing_[field] << '\n';
+  }
+}
+
+void SessionAnalytics::writeJson(std::ostream& out) const {
+  flushOrders();
+  out << std::setprecision(6);
+  out << "{\n  \"sessions\": " << sessions_ << ",\n  \"completed\": " << completed_
+      << ",\n  \"metrics\": {";
+  for (std::size_t metric = 0; metric < kMetricCount; ++metric) {
+    const Series& series = series_[metric];
+    out << (metric == 0 ? "\n" : ",\n") << "    \"" << kMetrics[metric].name
+        << "\": {\"count\": " << series.stats.count() << ", \"mean\": " << series.stats.mean()
+        << ", \"stddev\": " << std::sqrt(series.stats.variance())
+        << ", \"min\": " << series.stats.min();
+    for (std::size_t i = 0; i < std::size(kPercentiles); ++i) {
+      out << ", \"" << kPercentileNames[i] << "\": " << series.histogram.percentile(kPercentiles[i]);
+    }
+    out << ", \"max\": " << series.stats.max() << '}';
+  }
+  out << "\n  },\n  \"missing\": {";
+  for (std::size_t field = 0; field < kOrderFieldCount; ++field) {
+    out << (field == 0 ? "" : ", ") << '"' << orderFieldName(static_cast<OrderField>(field))
+        << "\": " << missing_[field];
+  }
+  out << "}\n}\n";
+}
+
+bool SessionAnalytics::writeCsv(const std::string& path) const {
+  std::ofstream out(path);
+  if (!out) {
+    return false;
+  }
+  writeCsv(out);
+  return static_cast<bool>(out);
+}
+
+bool SessionAnalytics::writeJson(const std::string& path) const {
+  std::ofstream out(path);
+  if (!out) {
+    return false;
+  }
+  writeJson(out);
+  return static_cast<bool>(out);
+}
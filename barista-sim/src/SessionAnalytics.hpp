@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Order.hpp"
+
+struct OrderReport;
+
+// Log-linear histogram in the style of HdrHistogram. Values are counted in
+// units of `unit` (anything smaller rounds to it), exact below 128 units and
+// in buckets 1/128 of their magnitude wide above that, so every percentile
+// is within 1% of a recorded value. Covers 0 to 2^32 units (larger values
+// clamp) in a fixed 26 KiB, however many values are recorded.
+class Histogram {
+ public:
+  explicit Histogram(double unit = 1.0);
+
+  void record(double value);
+  // Adds other's counts; throws std::invalid_argument when the units differ.
+  void merge(const Histogram& other);
+
+  [[nodiscard]] std::uint64_t count() const;
+  // Value at or below which `fraction` (0..1) of the recorded values fall,
+  // as the midpoint of its bucket; 0 when empty.
+  [[nodiscard]] double percentile(double fraction) const;
+  [[nodiscard]] double unit() const;
+
+ private:
+  static constexpr unsigned kSubBucketBits = 7;
+  static constexpr std::uint64_t kSubBuckets = std::uint64_t{1} << kSubBucketBits;
+  static constexpr unsigned kMaxValueBits = 32;
+  static constexpr std::size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+  [[nodiscard]] static std::size_t bucketOf(std::uint64_t units);
+  [[nodiscard]] static double bucketMidpoint(std::size_t bucket);
+
+  double unit_;
+  std::uint64_t count_{0};
+  std::vector<std::uint64_t> counts_;
+};
+
+// Count, mean, variance (Welford), minimum and maximum, mergeable with
+// Chan's pairwise update.
+class RunningStats {
+ public:
+  void record(double value);
+  void merge(const RunningStats& other);
+
+  [[nodiscard]] std::uint64_t count() const;
+  [[nodiscard]] double mean() const;
+  // Sample variance; 0 below two values.
+  [[nodiscard]] double variance() const;
+  [[nodiscard]] double min() const;
+  [[nodiscard]] double max() const;
+
+ private:
+  std::uint64_t count_{0};
+  double mean_{0.0};
+  double m2_{0.0};
+  double min_{0.0};
+  double max_{0.0};
+};
+
+// Aggregates OrderReports from many sessions into fixed memory: running
+// statistics and a histogram per metric, plus completion and missing-field
+// counts. Reports are not kept, so a sink can take millions: their orders
+// wait in a small fixed batch and are validated together with
+// validateOrders when it fills or before any read. Aggregates are not
+// thread-safe, reads included; give every thread its own and merge() them at
+// the end.
+class SessionAnalytics {
+ public:
+  enum class Metric : std::uint8_t { TimeToOrder, PathDistance, Steps, PenaltyTime, Count };
+  static constexpr std::size_t kMetricCount = static_cast<std::size_t>(Metric::Count);
+
+  SessionAnalytics();
+
+  void add(const OrderReport& report);
+  void merge(const SessionAnalytics& other);
+
+  [[nodiscard]] std::uint64_t sessions() const;
+  [[nodiscard]] std::uint64_t completed() const;
+  // Sessions that ended without this field.
+  [[nodiscard]] std::uint64_t missing(OrderField field) const;
+  [[nodiscard]] const RunningStats& stats(Metric metric) const;
+  [[nodiscard]] const Histogram& histogram(Metric metric) const;
+
+  // One row per metric: count, mean, stddev, min, p50, p90, p95, p99, max.
+  // Then one row per order field, with the sessions that missed it.
+  void writeCsv(std::ostream& out) const;
+  // The same numbers as one JSON object.
+  void writeJson(std::ostream& out) const;
+  bool writeCsv(const std::string& path) const;
+  bool writeJson(const std::string& path) const;
+
+ private:
+  struct Series {
+    RunningStats stats;
+    Histogram histogram;
+  };
+
+  static constexpr std::size_t kOrderBatch = 64;
+
+  // Validates the pending orders into completed_ and missing_. Reads call it
+  // first, so the batch and those counts are mutable.
+  void flushOrders() const;
+
+  std::vector<Series> series_;
+  std::uint64_t sessions_{0};
+  mutable std::uint64_t completed_{0};
+  mutable std::array<std::uint64_t, kOrderFieldCount> missing_{};
+  // One batch shares a required mask; a report with another flushes first.
+  mutable std::array<Order, kOrderBatch> pendingOrders_{};
+  mutable std::size_t pendingCount_{0};
+  mutable OrderFieldMask pendingRequired_{kAllOrderFields};
+};
@@ -0,0 +1,124 @@
+#include "SpatialHash.hpp"
+
+#include <algorithm>
+
+namespace {
+[[nodiscard]] std::size_t roundUpToPowerOfTwo(std::size_t value) {
+  std::size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// std::floor is a libm call on baseline x86-64; this is all cellsFor needs.
+[[nodiscard]] int floorToInt(float value) {
+  const auto truncated = static_cast<int>(value);
+  return truncated - (value < static_cast<float>(truncated) ? 1 : 0);
+}
+
+// Same rule as sf::Rect::intersects: boxes that only touch do not overlap.
+[[nodiscard]] bool intersects(const sf::FloatRect& a, const sf::FloatRect& b) {
+  return a.left < b.left + b.width && b.left < a.left + a.width && a.top < b.top + b.height &&
+         b.top < a.top + a.height;
+}
+}  // namespace
+
+SpatialHash::SpatialHash(float cellSize, std::size_t bucketCount)
+    : inverseCellSize_(1.0f / std::max(cellSize, 1.0f)),
+      bucketMask_(roundUpToPowerOfTwo(std::max<std::size_t>(bucketCount, 1)) - 1),
+      buckets_(bucketMask_ + 1) {}
+
+void SpatialHash::clear() {
+  for (const std::size_t bucket : usedBuckets_) {
+    buckets_[bucket].clear();
+  }
+  usedBuckets_.clear();
+  items_.clear();
+}
+
+void SpatialHash::insert(Id id, const sf::FloatRect& bounds) {
+  const auto index = static_cast<std::uint32_t>(items_.size());
+  items_.push_back({id, bounds});
+
+  const CellRange cells = cellsFor(bounds);
+  for (int y = cells.minY; y <= cells.maxY; ++y) {
+    for (int x = cells.minX; x <= cells.maxX; ++x) {
+      const std::size_t bucket = bucketFor(x, y);
+      auto& entries = buckets_[bucket];
+      if (entries.empty()) {
+        usedBuckets_.push_back(bucket);
+      }
+      // Two cells of one item can share a bucket; one entry is enough.
+      if (entries.empty() || entries.back() != index) {
+        entries.push_back(index);
+      }
+    }
+  }
+}
+
+std::size_t SpatialHash::size() const {
+  return items_.size();
+}
+
+void SpatialHash::queryRect(const sf::FloatRect& area, std::vector<Id>& out) const {
+  query(area, out, [&area](const sf::FloatRect& bounds) { return intersects(area, bounds); });
+}
+
+void SpatialHash::queryRadius(const sf::Vector2f& center, float radius,
+                              std::vector<Id>& out) const {
+  const sf::FloatRect area(center.x - radius, center.y - radius, radius * 2.0f, radius * 2.0f);
+  const float radiusSquared = radius * radius;
+  query(area, out, [&](const sf::FloatRect& bounds) {
+    const float dx = std::max({bounds.left - center.x, 0.0f, center.x - (bounds.left + bounds.width)});
+    const float dy = std::max({bounds.top - center.y, 0.0f, center.y - (bounds.top + bounds.height)});
+    return dx * dx + dy * dy <= radiusSquared;
+  });
+}
+
+SpatialHash::CellRange SpatialHash::cellsFor(const sf::FloatRect& area) const {
+  return {
+      floorToInt(area.left * inverseCellSize_),
+      floorToInt(area.top * inverseCellSize_),
+      floorToInt((area.left + area.width) * inverseCellSize_),
+      floorToInt((area.top + area.height) * inverseCellSize_),
+  };
+}
+
+std::size_t SpatialHash::bucketFor(int cellX, int cellY) const {
+  const auto hash = (static_cast<std::uint32_t>(cellX) * 73856093U) ^
+                    (static_cast<std::uint32_t>(cellY) * 19349663U);
+  return hash & bucketMask_;
+}
+
+template <typename Accept>
+void SpatialHash::query(const sf::FloatRect& area, std::vector<Id>& out, Accept&& accept) const {
+  if (items_.empty()) {
+    return;
+  }
+
+  // Stamps mark items already visited by this query, so items spanning
+  // several cells (or colliding buckets) are tested and reported once.
+  if (stamps_.size() < items_.size()) {
+    stamps_.resize(items_.size(), 0);
+  }
+  if (++stamp_ == 0) {
+    std::fill(stamps_.begin(), stamps_.end(), 0);
+    stamp_ = 1;
+  }
+
+  const CellRange cells = cellsFor(area);
+  for (int y = cells.minY; y <= cells.maxY; ++y) {
+    for (int x = cells.minX; x <= cells.maxX; ++x) {
+      for (const std::uint32_t index : buckets_[bucketFor(x, y)]) {
+        if (stamps_[index] == stamp_) {
+          continue;
+        }
+        stamps_[index] = stamp_;
+        if (accept(items_[index].bounds)) {
+          out.push_back(items_[index].id);
+        }
+      }
+    }
+  }
+}
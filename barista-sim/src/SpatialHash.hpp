@@ -0,0 +1,60 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Uniform-grid broadphase over axis-aligned boxes. Each item is filed under
+// every cell its box overlaps, in a fixed number of hashed buckets, so
+// queries only look at items near the query area no matter how many there
+// are. Buckets keep their capacity across clear(), so rebuilding a dynamic
+// index every tick does not allocate once it has warmed up.
+//
+// Queries reuse internal scratch state and are not safe to run concurrently
+// on the same instance.
+class SpatialHash {
+ public:
+  using Id = std::uint32_t;
+
+  explicit SpatialHash(float cellSize = 64.0f, std::size_t bucketCount = 1024);
+
+  void clear();
+  void insert(Id id, const sf::FloatRect& bounds);
+
+  [[nodiscard]] std::size_t size() const;
+
+  // Appends the ids of items whose box overlaps area (each at most once).
+  void queryRect(const sf::FloatRect& area, std::vector<Id>& out) const;
+  // Appends the ids of items whose box comes within radius of center.
+  void queryRadius(const sf::Vector2f& center, float radius, std::vector<Id>& out) const;
+
+ private:
+  struct Item {
+    Id id;
+    sf::FloatRect bounds;
+  };
+
+  struct CellRange {
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+  };
+
+  [[nodiscard]] CellRange cellsFor(const sf::FloatRect& area) const;
+  [[nodiscard]] std::size_t bucketFor(int cellX, int cellY) const;
+
+  template <typename Accept>
+  void query(const sf::FloatRect& area, std::vector<Id>& out, Accept&& accept) const;
+
+  float inverseCellSize_;
+  std::size_t bucketMask_;
+  std::vector<Item> items_;
+  std::vector<std::vector<std::uint32_t>> buckets_;
+  std::vector<std::size_t> usedBuckets_;
+
+  mutable std::vector<std::uint32_t> stamps_;
+  mutable std::uint32_t stamp_{0};
+};
@@ -0,0 +1,104 @@
+#include "SpriteBatch.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+void SpriteBatch::clear() {
+  entries_.clear();
+  order_.clear();
+  vertices_.clear();
+  runs_.clear();
+  dirty_ = false;
+}
+
+void SpriteBatch::add(const sf::Sprite& sprite, float depth, const sf::Transform& transform,
+                      const sf::BlendMode& blendMode) {
+  const sf::IntRect rect = sprite.getTextureRect();
+  const auto width = static_cast<float>(std::abs(rect.width));
+  const auto height = static_cast<float>(std::abs(rect.height));
+  const auto left = static_cast<float>(rect.left);
+  const auto top = static_cast<float>(rect.top);
+  const auto right = static_cast<float>(rect.left + rect.width);
+  const auto bottom = static_cast<float>(rect.top + rect.height);
+
+  const sf::Transform world = transform * sprite.getTransform();
+  const sf::Color color = sprite.getColor();
+
+  Entry entry{depth, static_cast<std::uint32_t>(entries_.size()), sprite.getTexture(), blendMode,
+              {}};
+  entry.corners[0] = sf::Vertex(world.transformPoint(0.0f, 0.0f), color, {left, top});
+  entry.corners[1] = sf::Vertex(world.transformPoint(width, 0.0f), color, {right, top});
+  entry.corners[2] = sf::Vertex(world.transformPoint(0.0f, height), color, {left, bottom});
+  entry.corners[3] = sf::Vertex(world.transformPoint(width, height), color, {right, bottom});
+  entries_.push_back(entry);
+  dirty_ = true;
+}
+
+void SpriteBatch::addQuads(const sf::Texture* texture, const sf::Vertex* corners,
+                           const float* depths, std::size_t count,
+                           const sf::BlendMode& blendMode) {
+  for (std::size_t i = 0; i < count; ++i) {
+    Entry entry{depths[i], static_cast<std::uint32_t>(entries_.size()), texture, blendMode, {}};
+    std::copy_n(corners + i * 4, 4, entry.corners.begin());
+    entries_.push_back(entry);
+  }
+  dirty_ = dirty_ || count > 0;
+}
+
+std::size_t SpriteBatch::spriteCount() const {
+  return entries_.size();
+}
+
+std::size_t SpriteBatch::runCount() const {
+  build();
+  return runs_.size();
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+  build();
+
+  for (const auto& run : runs_) {
+    sf::RenderStates runStates = states;
+    runStates.texture = run.texture;
+    runStates.blendMode = run.blendMode;
+    target.draw(&vertices_[run.firstVertex], run.vertexCount, sf::Triangles, runStates);
+  }
+}
+
+void SpriteBatch::build() const {
+  if (!dirty_) {
+    return;
+  }
+  dirty_ = false;
+
+  order_.resize(entries_.size());
+  for (std::uint32_t i = 0; i < order_.size(); ++i) {
+    order_[i] = i;
+  }
+  std::sort(order_.begin(), order_.end(), [this](std::uint32_t a, std::uint32_t b) {
+    const Entry& lhs = entries_[a];
+    const Entry& rhs = entries_[b];
+    return lhs.depth != rhs.depth ? lhs.depth < rhs.depth : lhs.sequence < rhs.sequence;
+  });
+
+  vertices_.clear();
+  runs_.clear();
+  vertices_.reserve(entries_.size() * 6);
+
+  for (const std::uint32_t index : order_) {
+    const Entry& entry = entries_[index];
+    if (runs_.empty() || runs_.back().texture != entry.texture ||
+        runs_.back().blendMode != entry.blendMode) {
+      runs_.push_back({entry.texture, entry.blendMode, vertices_.size(), 0});
+    }
+
+    const auto& c = entry.corners;
+    vertices_.push_back(c[0]);
+    vertices_.push_back(c[1]);
+    vertices_.push_back(c[2]);
+    vertices_.push_back(c[2]);
+    vertices_.push_back(c[1]);
+    vertices_.push_back(c[3]);
+    runs_.back().vertexCount += 6;
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Collects sprites for one frame and draws them back-to-front by depth (ties
+// keep insertion order). Consecutive sprites that share a texture and blend
+// mode are merged into a single triangle list, so a crowd using one texture
+// costs one draw call however many members it has. Storage is reused across
+// frames; sorting and vertex generation happen lazily on the first draw after
+// a change.
+class SpriteBatch : public sf::Drawable {
+ public:
+  void clear();
+
+  void add(const sf::Sprite& sprite, float depth,
+           const sf::Transform& transform = sf::Transform::Identity,
+           const sf::BlendMode& blendMode = sf::BlendAlpha);
+  // Adds count prebuilt quads sharing one texture: corners holds 4 vertices
+  // per quad (top-left, top-right, bottom-left, bottom-right) in world space.
+  void addQuads(const sf::Texture* texture, const sf::Vertex* corners, const float* depths,
+                std::size_t count, const sf::BlendMode& blendMode = sf::BlendAlpha);
+
+  [[nodiscard]] std::size_t spriteCount() const;
+  // Number of draw calls the batch issues when drawn.
+  [[nodiscard]] std::size_t runCount() const;
+
+ private:
+  struct Entry {
+    float depth;
+    std::uint32_t sequence;
+    const sf::Texture* texture;
+    sf::BlendMode blendMode;
+    std::array<sf::Vertex, 4> corners;
+  };
+
+  struct Run {
+    const sf::Texture* texture;
+    sf::BlendMode blendMode;
+    std::size_t firstVertex;
+    std::size_t vertexCount;
+  };
+
+  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  void build() const;
+
+  std::vector<Entry> entries_;
+
+  mutable std::vector<std::uint32_t> order_;
+  mutable std::vector<sf::Vertex> vertices_;
+  mutable std::vector<Run> runs_;
+  mutable bool dirty_{false};
+};
@@ -0,0 +1,75 @@
+#include "StaticLayer.hpp"
+
+#include <SFML/Config.hpp>
+#include <atomic>
+#include <cmath>
+#include <utility>
+
+namespace {
+// Source colour is already multiplied by its alpha.
+#if SFML_VERSION_MAJOR >= 3
+const sf::BlendMode kPremultipliedAlpha(sf::BlendMode::Factor::One,
+                                        sf::BlendMode::Factor::OneMinusSrcAlpha);
+#else
+const sf::BlendMode kPremultipliedAlpha(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha);
+#endif
+}  // namespace
+
+std::uint64_t StaticLayer::newRevision() {
+  static std::atomic<std::uint64_t> counter{0};
+  return ++counter;
+}
+
+void StaticLayer::setArea(const sf::FloatRect& area) {
+  const float left = std::floor(area.left);
+  const float top = std::floor(area.top);
+  const sf::FloatRect rounded(left, top, std::ceil(area.left + area.width) - left,
+                              std::ceil(area.top + area.height) - top);
+  if (rounded == area_) {
+    return;
+  }
+  area_ = rounded;
+  quad_.setPosition(area_.left, area_.top);
+  revision_ = 0;
+}
+
+const sf::FloatRect& StaticLayer::area() const {
+  return area_;
+}
+
+StaticLayer::Cache StaticLayer::prepare(std::uint64_t revision) {
+  if (unavailable_ || area_.width <= 0.0f || area_.height <= 0.0f) {
+    return Cache::Unavailable;
+  }
+
+  const sf::Vector2u size(static_cast<unsigned>(area_.width), static_cast<unsigned>(area_.height));
+  if (!texture_ || texture_->getSize() != size) {
+    auto texture = std::make_unique<sf::RenderTexture>();
+#if SFML_VERSION_MAJOR >= 3
+    const bool created = texture->resize(size);
+#else
+    const bool created = texture->create(size.x, size.y);
+#endif
+    if (!created) {
+      // No framebuffer support; draw straight to the target from now on.
+      unavailable_ = true;
+      texture_.reset();
+      return Cache::Unavailable;
+    }
+    texture_ = std::move(texture);
+    quad_.setTexture(texture_->getTexture(), true);
+    revision_ = 0;
+  }
+
+  if (revision == revision_) {
+    return Cache::Fresh;
+  }
+  revision_ = revision;
+  texture_->setView(sf::View(area_));
+  texture_->clear(sf::Color::Transparent);
+  return Cache::Stale;
+}
+
+void StaticLayer::present(sf::RenderTarget& target) {
+  target.draw(quad_, sf::RenderStates(kPremultipliedAlpha));
+}
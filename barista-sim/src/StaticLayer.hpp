@@ -0,0 +1,63 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+
+// Drawables that rarely change, composited into an sf::RenderTexture once
+// and then drawn as a single textured quad, until their content changes.
+// Owners identify content by a revision (see newRevision()) and bump it
+// whenever anything in the layer changes.
+//
+// The texture is cleared to transparent and drawn into with normal alpha
+// blending, which leaves it holding premultiplied colour; it is drawn back
+// with a premultiplied blend, so translucent content lands exactly as if it
+// had been drawn straight onto the target. Covers a fixed area of the target
+// at one texel per pixel, so text stays sharp.
+class StaticLayer {
+ public:
+  // Unique across the program, so a layer never mistakes one owner's
+  // content for another's.
+  [[nodiscard]] static std::uint64_t newRevision();
+
+  // Part of the target the layer covers, in target coordinates, rounded out
+  // to whole pixels. Content outside it is cut off.
+  void setArea(const sf::FloatRect& area);
+  [[nodiscard]] const sf::FloatRect& area() const;
+
+  // Draws the layer. When revision differs from the last draw, first calls
+  // compose(texture) to redraw the content. Without render texture support
+  // compose(target) runs on every draw instead.
+  template <typename Compose>
+  void draw(sf::RenderTarget& target, std::uint64_t revision, const Compose& compose);
+
+ private:
+  enum class Cache : std::uint8_t { Fresh, Stale, Unavailable };
+
+  // Makes sure the texture exists and matches the area, and clears it when
+  // the content must be composited again.
+  Cache prepare(std::uint64_t revision);
+  void present(sf::RenderTarget& target);
+
+  sf::FloatRect area_;
+  std::unique_ptr<sf::RenderTexture> texture_;
+  sf::Sprite quad_;
+  std::uint64_t revision_{0};
+  bool unavailable_{false};
+};
+
+template <typename Compose>
+void StaticLayer::draw(sf::RenderTarget& target, std::uint64_t revision, const Compose& compose) {
+  switch (prepare(revision)) {
+    case Cache::Unavailable:
+      compose(target);
+      return;
+    case Cache::Stale:
+      compose(static_cast<sf::RenderTarget&>(*texture_));
+      texture_->display();
+      break;
+    case Cache::Fresh:
+      break;
+  }
+  present(target);
+}
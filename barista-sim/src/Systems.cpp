@@ -0,0 +1,90 @@
+#include "Systems.hpp"
+
+#include <cmath>
+
+#include "SpriteBatch.hpp"
+#include "Utils.hpp"
+
+namespace {
+constexpr float kArrivalDistance = 4.0f;
+
+// Table sprites sit at the origin, so their global bounds are the bounds
+// relative to the entity's position.
+[[nodiscard]] sf::FloatRect placedBounds(const sf::Sprite& sprite, const sf::Vector2f& position) {
+  sf::FloatRect bounds = sprite.getGlobalBounds();
+  bounds.left += position.x;
+  bounds.top += position.y;
+  return bounds;
+}
+}  // namespace
+
+void beginTick(World& world) {
+  world.eachChunk<Transform>([](std::size_t count, Transform* transforms) {
+    for (std::size_t i = 0; i < count; ++i) {
+      transforms[i].previous = transforms[i].position;
+    }
+  });
+}
+
+void integrateVelocities(World& world, float dt) {
+  world.eachChunk<Transform, Velocity>(
+      [dt](std::size_t count, Transform* transforms, const Velocity* velocities) {
+        for (std::size_t i = 0; i < count; ++i) {
+          transforms[i].position += velocities[i].value * dt;
+        }
+      });
+}
+
+void followPaths(World& world, float dt) {
+  world.eachChunk<Transform, PathMotion>(
+      [dt](std::size_t count, Transform* transforms, PathMotion* paths) {
+        for (std::size_t i = 0; i < count; ++i) {
+          PathMotion& path = paths[i];
+          if (path.cursor >= path.count) {
+            continue;
+          }
+          const sf::Vector2f toTarget = path.nodes[path.cursor] - transforms[i].position;
+          if (utils::length(toTarget) < kArrivalDistance) {
+            ++path.cursor;
+            continue;
+          }
+          transforms[i].position += utils::normalize(toTarget) * path.speed * dt;
+        }
+      });
+}
+
+void animateIdle(World& world, float dt) {
+  world.eachChunk<IdleAnimation, SpriteRef>(
+      [dt](std::size_t count, IdleAnimation* idles, SpriteRef* refs) {
+        for (std::size_t i = 0; i < count; ++i) {
+          idles[i].phase += idles[i].speed * dt;
+          refs[i].drawOffset.y = std::sin(idles[i].phase) * idles[i].amplitude;
+        }
+      });
+}
+
+sf::FloatRect spriteBounds(const World& world, std::span<const sf::Sprite> sprites,
+                           EntityId entity) {
+  const Transform* transform = world.get<Transform>(entity);
+  const SpriteRef* ref = world.get<SpriteRef>(entity);
+  if (transform == nullptr || ref == nullptr) {
+    return {};
+  }
+  return placedBounds(sprites[ref->sprite], transform->position);
+}
+
+void batchSprites(const World& world, std::span<const sf::Sprite> sprites, SpriteBatch& batch,
+                  float alpha) {
+  world.eachChunk<Transform, SpriteRef>(
+      [&](std::size_t count, const Transform* transforms, const SpriteRef* refs) {
+        for (std::size_t i = 0; i < count; ++i) {
+          const sf::Sprite& sprite = sprites[refs[i].sprite];
+          const Transform& transform = transforms[i];
+          const sf::Vector2f drawn = utils::lerp(transform.previous, transform.position, alpha);
+          // Depth follows the feet, not the idle bob.
+          const sf::FloatRect bounds = placedBounds(sprite, transform.position);
+          batch.add(sprite, bounds.top + bounds.height + (drawn.y - transform.position.y),
+                    sf::Transform().translate(drawn + refs[i].drawOffset));
+        }
+      });
+}
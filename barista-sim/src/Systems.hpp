@@ -0,0 +1,29 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <span>
+
+#include "Components.hpp"
+#include "Ecs.hpp"
+
+class SpriteBatch;
+
+// Systems over World components, each one pass over the chunks holding
+// what it needs. Run beginTick() first in every fixed tick, before anything
+// moves.
+void beginTick(World& world);
+void integrateVelocities(World& world, float dt);
+// Steps each unfinished PathMotion towards its current node, moving on once
+// within 4 px of it.
+void followPaths(World& world, float dt);
+void animateIdle(World& world, float dt);
+
+// Global bounds of entity's sprite at its current position; empty when it
+// has no Transform or SpriteRef.
+[[nodiscard]] sf::FloatRect spriteBounds(const World& world, std::span<const sf::Sprite> sprites,
+                                         EntityId entity);
+// Queues every sprite entity at its interpolated position, depth-sorted by
+// the bottom of its bounds.
+void batchSprites(const World& world, std::span<const sf::Sprite> sprites, SpriteBatch& batch,
+                  float alpha);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer triple buffer. The producer fills
+// writeBuffer() and publish()es it; the consumer acquire()s the most recently
+// published buffer and reads it through readBuffer(). Neither side ever waits
+// and the consumer skips stale frames if the producer runs ahead.
+template <typename T>
+class TripleBuffer {
+ public:
+  T& writeBuffer() {
+    return buffers_[back_];
+  }
+
+  void publish() {
+    back_ = middle_.exchange(static_cast<std::uint8_t>(back_ | kFreshBit), std::memory_order_acq_rel) &
+            kIndexMask;
+  }
+
+  // Returns true if a newer buffer was published since the last call.
+  bool acquire() {
+    if ((middle_.load(std::memory_order_relaxed) & kFreshBit) == 0) {
+      return false;
+    }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    return true;
+  }
+
+  [[nodiscard]] const T& readBuffer() const {
+    return buffers_[front_];
+  }
+
+ private:
+  static constexpr std::uint8_t kIndexMask = 0x3;
+  static constexpr std::uint8_t kFreshBit = 0x4;
+
+  std::array<T, 3> buffers_{};
+  std::uint8_t back_{0};
+  std::atomic<std::uint8_t> middle_{1};
+  std::uint8_t front_{2};
+};
@@ -0,0 +1,202 @@
+#include "TypewriterText.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+std::uint64_t nextRevision() {
+  static std::atomic<std::uint64_t> counter{0};
+  return ++counter;
+}
+
+[[nodiscard]] bool isBreak(sf::Uint32 c) {
+  return c == U' ' || c == U'\t' || c == U'\n';
+}
+
+void appendGlyphQuad(std::vector<sf::Vertex>& vertices, sf::Vector2f position,
+                     const sf::Glyph& glyph, const sf::Color& color) {
+  // Same one-pixel padding sf::Text uses, so smoothing doesn't clip edges.
+  constexpr float kPadding = 1.0f;
+
+  const float left = position.x + glyph.bounds.left - kPadding;
+  const float top = position.y + glyph.bounds.top - kPadding;
+  const float right = position.x + glyph.bounds.left + glyph.bounds.width + kPadding;
+  const float bottom = position.y + glyph.bounds.top + glyph.bounds.height + kPadding;
+
+  const float u1 = static_cast<float>(glyph.textureRect.left) - kPadding;
+  const float v1 = static_cast<float>(glyph.textureRect.top) - kPadding;
+  const float u2 =
+      static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + kPadding;
+  const float v2 =
+      static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + kPadding;
+
+  vertices.emplace_back(sf::Vector2f(left, top), color, sf::Vector2f(u1, v1));
+  vertices.emplace_back(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1));
+  vertices.emplace_back(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2));
+  vertices.emplace_back(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2));
+  vertices.emplace_back(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1));
+  vertices.emplace_back(sf::Vector2f(right, bottom), color, sf::Vector2f(u2, v2));
+}
+}  // namespace
+
+void TypewriterText::setFont(const sf::Font& font) {
+  if (font_ != &font) {
+    font_ = &font;
+    invalidateLayout();
+  }
+}
+
+void TypewriterText::setCharacterSize(unsigned size) {
+  if (characterSize_ != size) {
+    characterSize_ = size;
+    invalidateLayout();
+  }
+}
+
+void TypewriterText::setWrapWidth(float width) {
+  if (wrapWidth_ != width) {
+    wrapWidth_ = width;
+    invalidateLayout();
+  }
+}
+
+void TypewriterText::setString(const sf::String& string) {
+  if (string_ != string) {
+    string_ = string;
+    invalidateLayout();
+  }
+}
+
+void TypewriterText::setFillColor(const sf::Color& color) {
+  if (fillColor_ == color) {
+    return;
+  }
+  fillColor_ = color;
+  if (!layoutDirty_) {
+    for (auto& vertex : vertices_) {
+      vertex.color = color;
+    }
+  }
+}
+
+void TypewriterText::setVisibleGlyphs(std::size_t count) {
+  visibleGlyphs_ = std::min(count, string_.getSize());
+}
+
+const sf::Font* TypewriterText::getFont() const {
+  return font_;
+}
+
+unsigned TypewriterText::getCharacterSize() const {
+  return characterSize_;
+}
+
+float TypewriterText::getWrapWidth() const {
+  return wrapWidth_;
+}
+
+const sf::String& TypewriterText::getString() const {
+  return string_;
+}
+
+const sf::Color& TypewriterText::getFillColor() const {
+  return fillColor_;
+}
+
+std::size_t TypewriterText::glyphCount() const {
+  return string_.getSize();
+}
+
+std::size_t TypewriterText::visibleGlyphs() const {
+  return visibleGlyphs_;
+}
+
+std::uint64_t TypewriterText::revision() const {
+  return revision_;
+}
+
+void TypewriterText::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+  if (!font_ || visibleGlyphs_ == 0) {
+    return;
+  }
+
+  ensureLayout();
+  const std::uint32_t vertexCount = vertexEnd_[visibleGlyphs_ - 1];
+  if (vertexCount == 0) {
+    return;
+  }
+
+  states.transform *= getTransform();
+  states.texture = &font_->getTexture(characterSize_);
+  target.draw(vertices_.data(), vertexCount, sf::Triangles, states);
+}
+
+void TypewriterText::invalidateLayout() {
+  layoutDirty_ = true;
+  revision_ = nextRevision();
+  visibleGlyphs_ = std::min(visibleGlyphs_, string_.getSize());
+}
+
+void TypewriterText::ensureLayout() const {
+  if (!layoutDirty_) {
+    return;
+  }
+  layoutDirty_ = false;
+
+  vertices_.clear();
+  vertexEnd_.clear();
+  vertices_.reserve(string_.getSize() * 6);
+  vertexEnd_.reserve(string_.getSize());
+
+  const auto advanceOf = [this](sf::Uint32 c) {
+    return font_->getGlyph(c, characterSize_, false).advance;
+  };
+  const float spaceWidth = advanceOf(U' ');
+  const float lineSpacing = font_->getLineSpacing(characterSize_);
+
+  float x = 0.0f;
+  float y = static_cast<float>(characterSize_);
+  sf::Uint32 previous = 0;
+
+  for (std::size_t i = 0; i < string_.getSize(); ++i) {
+    const sf::Uint32 c = string_[i];
+
+    // At the start of each word, move it to the next line if it won't fit.
+    if (wrapWidth_ > 0.0f && x > 0.0f && !isBreak(c) && (i == 0 || isBreak(string_[i - 1]))) {
+      float wordWidth = 0.0f;
+      for (std::size_t j = i; j < string_.getSize() && !isBreak(string_[j]); ++j) {
+        wordWidth += advanceOf(string_[j]);
+      }
+      if (x + wordWidth > wrapWidth_) {
+        x = 0.0f;
+        y += lineSpacing;
+        previous = 0;
+      }
+    }
+
+    x += font_->getKerning(previous, c, characterSize_);
+    previous = c;
+
+    switch (c) {
+      case U' ':
+        x += spaceWidth;
+        break;
+      case U'\t':
+        x += spaceWidth * 4.0f;
+        break;
+      case U'\n':
+        x = 0.0f;
+        y += lineSpacing;
+        previous = 0;
+        break;
+      default: {
+        const sf::Glyph& glyph = font_->getGlyph(c, characterSize_, false);
+        appendGlyphQuad(vertices_, sf::Vector2f(x, y), glyph, fillColor_);
+        x += glyph.advance;
+        break;
+      }
+    }
+
+    vertexEnd_.push_back(static_cast<std::uint32_t>(vertices_.size()));
+  }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Text that is revealed glyph by glyph. The whole string is laid out once
+// into a vertex array (lazily, on the first draw after a change, so headless
+// runs never touch the font) and revealing more of it only moves the number
+// of vertices submitted. Words wrap at the configured width.
+class TypewriterText : public sf::Drawable, public sf::Transformable {
+ public:
+  void setFont(const sf::Font& font);
+  void setCharacterSize(unsigned size);
+  void setWrapWidth(float width);
+  void setString(const sf::String& string);
+  void setFillColor(const sf::Color& color);
+  void setVisibleGlyphs(std::size_t count);
+
+  [[nodiscard]] const sf::Font* getFont() const;
+  [[nodiscard]] unsigned getCharacterSize() const;
+  [[nodiscard]] float getWrapWidth() const;
+  [[nodiscard]] const sf::String& getString() const;
+  [[nodiscard]] const sf::Color& getFillColor() const;
+  [[nodiscard]] std::size_t glyphCount() const;
+  [[nodiscard]] std::size_t visibleGlyphs() const;
+
+  // Changes whenever the layout inputs (font, size, wrap width, string)
+  // change; unique across instances, so copies can detect stale layouts.
+  [[nodiscard]] std::uint64_t revision() const;
+
+ private:
+  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  void invalidateLayout();
+  void ensureLayout() const;
+
+  const sf::Font* font_{nullptr};
+  unsigned characterSize_{30};
+  float wrapWidth_{0.0f};
+  sf::String string_;
+  sf::Color fillColor_{sf::Color::White};
+  std::size_t visibleGlyphs_{0};
+  std::uint64_t revision_{0};
+
+  mutable std::vector<sf::Vertex> vertices_;
+  // vertexEnd_[i] is the vertex count that shows the first i + 1 characters.
+  mutable std::vector<std::uint32_t> vertexEnd_;
+  mutable bool layoutDirty_{true};
+};
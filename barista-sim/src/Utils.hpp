@@ -1,8 +1,10 @@
 #pragma once
 
+#include <SFML/System/String.hpp>
+#include <SFML/System/Utf.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <cmath>
-#include <random>
+#include <string_view>
 
 namespace utils {
 
@@ -32,15 +34,23 @@ inline float distance(const sf::Vector2f& a, const sf::Vector2f& b) {
   return length(a - b);
 }
 
-inline std::mt19937& rng() {
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
-  return gen;
+// Rewrites an sf::String in place from ASCII text. The string keeps its
+// capacity, so reusing one per label avoids a heap allocation per update.
+inline void assignAscii(sf::String& target, std::string_view text) {
+  target.clear();
+  for (const char character : text) {
+    target += sf::String(static_cast<sf::Uint32>(static_cast<unsigned char>(character)));
+  }
 }
 
-inline float randomFloat(float min, float max) {
-  std::uniform_real_distribution<float> dist(min, max);
-  return dist(rng());
+// Like assignAscii, for UTF-8 text such as scenario lines.
+inline void assignUtf8(sf::String& target, std::string_view text) {
+  target.clear();
+  for (auto it = text.begin(); it != text.end();) {
+    sf::Uint32 codepoint = 0;
+    it = sf::Utf8::decode(it, text.end(), codepoint);
+    target += sf::String(codepoint);
+  }
 }
 
 }  // namespace utils
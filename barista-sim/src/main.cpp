@@ -1,9 +1,194 @@
 #include "App.hpp"
+#include "HeadlessRunner.hpp"
+#include "InputRecording.hpp"
+#include "InputScript.hpp"
+#include "ParallelRunner.hpp"
+#include "SessionAnalytics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+struct CommandLine {
+  bool headless{false};
+  std::string scriptPath;
+  // Recordings, or directories of them, to replay instead of a script.
+  std::vector<std::string> replayPaths;
+  std::size_t sessions{1};
+  // Writes <prefix>.csv and <prefix>.json summaries instead of one line per
+  // session.
+  std::string analyticsPrefix;
+  // Runs headless sessions on several threads, one world each.
+  bool parallel{false};
+  ParallelConfig parallelConfig;
+  AppOptions app;
+};
+
+CommandLine parseCommandLine(int argc, char** argv) {
+  CommandLine options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg(argv[i]);
+    if (arg == "--headless") {
+      options.headless = true;
+    } else if (arg.rfind("--script=", 0) == 0) {
+      options.scriptPath = std::string(arg.substr(9));
+    } else if (arg.rfind("--replay=", 0) == 0) {
+      options.headless = true;
+      options.replayPaths.emplace_back(arg.substr(9));
+    } else if (arg.rfind("--analytics=", 0) == 0) {
+      options.analyticsPrefix = std::string(arg.substr(12));
+    } else if (arg == "--parallel") {
+      options.headless = true;
+      options.parallel = true;
+    } else if (arg.rfind("--parallel=", 0) == 0) {
+      options.headless = true;
+      options.parallel = true;
+      options.parallelConfig.threads =
+          static_cast<unsigned>(std::strtoul(std::string(arg.substr(11)).c_str(), nullptr, 10));
+    } else if (arg == "--lockstep") {
+      options.headless = true;
+      options.parallel = true;
+      options.parallelConfig.mode = ParallelMode::LockStep;
+    } else if (arg.rfind("--record=", 0) == 0) {
+      options.app.recordDirectory = std::string(arg.substr(9));
+    } else if (arg.rfind("--seed=", 0) == 0) {
+      options.app.seed = std::strtoull(std::string(arg.substr(7)).c_str(), nullptr, 10);
+    } else if (arg.rfind("--sessions=", 0) == 0) {
+      options.sessions = std::strtoull(std::string(arg.substr(11)).c_str(), nullptr, 10);
+    } else if (arg == "--pipelined") {
+      options.app.pipelined = true;
+    } else if (arg.rfind("--sim-hz=", 0) == 0) {
+      options.app.simulationHz = std::strtof(std::string(arg.substr(9)).c_str(), nullptr);
+    } else if (arg == "--timestep=catchup") {
+      options.app.timeStepPolicy = TimeStepPolicy::CatchUp;
+    } else if (arg == "--timestep=dilate") {
+      options.app.timeStepPolicy = TimeStepPolicy::Dilate;
+    } else if (arg.rfind("--max-ticks=", 0) == 0) {
+      options.app.maxTicksPerFrame =
+          static_cast<unsigned>(std::strtoul(std::string(arg.substr(12)).c_str(), nullptr, 10));
+    } else if (arg.rfind("--customers=", 0) == 0) {
+      options.app.customerCount =
+          std::strtoull(std::string(arg.substr(12)).c_str(), nullptr, 10);
+    } else if (arg.rfind("--jobs=", 0) == 0) {
+      options.app.workerThreads =
+          static_cast<unsigned>(std::strtoul(std::string(arg.substr(7)).c_str(), nullptr, 10));
+    } else if (arg.rfind("--scenario=", 0) == 0) {
+      options.app.scenarioPath = std::string(arg.substr(11));
+    } else if (arg.rfind("--voices=", 0) == 0) {
+      options.app.audioVoices = std::strtoull(std::string(arg.substr(9)).c_str(), nullptr, 10);
+    } else if (arg == "--profile") {
+      options.app.profile = true;
+    } else if (arg.rfind("--profile-frames=", 0) == 0) {
+      options.app.profile = true;
+      options.app.profileFrames =
+          std::strtoull(std::string(arg.substr(17)).c_str(), nullptr, 10);
+    } else if (arg.rfind("--profile-out=", 0) == 0) {
+      options.app.profile = true;
+      options.app.profilePrefix = std::string(arg.substr(14));
+    } else {
+      throw std::runtime_error("Unknown argument: " + std::string(arg));
+    }
+  }
+  if (options.headless && options.scriptPath.empty() == options.replayPaths.empty()) {
+    throw std::runtime_error("--headless requires either --script=<path> or --replay=<path>");
+  }
+  return options;
+}
 
-int main() {
+// Directories stand for every .bsr file in them, in name order.
+std::vector<InputRecording> loadRecordings(const std::vector<std::string>& paths) {
+  std::vector<InputRecording> recordings;
+  for (const std::string& path : paths) {
+    if (!std::filesystem::is_directory(path)) {
+      recordings.push_back(InputRecording::loadFromFile(path));
+      continue;
+    }
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".bsr") {
+        files.push_back(entry.path());
+      }
+    }
+    std::sort(files.begin(), files.end());
+    for (const auto& file : files) {
+      recordings.push_back(InputRecording::loadFromFile(file.string()));
+    }
+  }
+  return recordings;
+}
+
+int runHeadless(const CommandLine& options) {
+  HeadlessConfig config;
+  config.customerCount = options.app.customerCount;
+  config.workerThreads = options.app.workerThreads;
+  config.scenarioPath = options.app.scenarioPath;
+  if (options.app.seed) {
+    config.seed = *options.app.seed;
+  }
+
+  SessionAnalytics analytics;
+  const bool summarize = !options.analyticsPrefix.empty();
+  std::cout << std::fixed << std::setprecision(2);
+  const ReportSink sink = [&](const OrderReport& report) {
+    if (summarize) {
+      analytics.add(report);
+      return;
+    }
+    std::cout << "time=" << report.timeSeconds << "s distance=" << report.pathDistance
+              << "px steps=" << report.steps << " complete=" << (report.complete ? "yes" : "no")
+              << '\n';
+  };
+
+  std::size_t expected = options.sessions;
+  std::size_t reported = 0;
+  const auto start = std::chrono::steady_clock::now();
+  if (options.replayPaths.empty()) {
+    const InputScript script = InputScript::loadFromFile(options.scriptPath);
+    reported = options.parallel ? runParallelSessions(script, options.sessions, config,
+                                                      options.parallelConfig, sink)
+                                : runHeadlessSessions(script, options.sessions, config, sink);
+  } else {
+    const std::vector<InputRecording> recordings = loadRecordings(options.replayPaths);
+    expected *= recordings.size();
+    reported = options.parallel ? runParallelReplays(recordings, options.sessions, config,
+                                                     options.parallelConfig, sink)
+                                : runHeadlessReplays(recordings, options.sessions, config, sink);
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  if (summarize) {
+    const std::string csvPath = options.analyticsPrefix + ".csv";
+    const std::string jsonPath = options.analyticsPrefix + ".json";
+    if (!analytics.writeCsv(csvPath) || !analytics.writeJson(jsonPath)) {
+      throw std::runtime_error("Failed to write " + csvPath + " / " + jsonPath);
+    }
+    const Histogram& times = analytics.histogram(SessionAnalytics::Metric::TimeToOrder);
+    std::cout << "sessions=" << analytics.sessions() << " complete=" << analytics.completed()
+              << " time p50=" << times.percentile(0.50) << "s p99=" << times.percentile(0.99)
+              << "s\n";
+  }
+  std::cerr << reported << '/' << expected << " sessions reported in " << elapsed.count()
+            << "s\n";
+  return reported == expected ? 0 : 2;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
   try {
-    App app;
+    const CommandLine options = parseCommandLine(argc, argv);
+    if (options.headless) {
+      return runHeadless(options);
+    }
+
+    App app(options.app);
     app.run();
   } catch (const std::exception& ex) {
     std::cerr << "Fatal error: " << ex.what() << '\n';
@@ -12,4 +197,3 @@ int main() {
 
   return 0;
 }
-
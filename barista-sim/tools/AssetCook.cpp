@@ -0,0 +1,137 @@
+// barista-sim-cook: packs every asset named in the manifests into one
+// AssetPack file (see src/AssetPack.hpp) so the game can map it instead of
+// opening and decoding each file at startup.
+//
+//   barista-sim-cook <output.pak>
+//
+// Asset paths in the manifests are relative, so run it from the project
+// root (the build does this automatically).
+
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "AssetPack.hpp"
+#include "ResourceIds.hpp"
+
+namespace {
+class PackBuilder {
+ public:
+  PackEntry& add(AssetKind kind, std::uint8_t id, const void* data, std::size_t size) {
+    while (blobs_.size() % kAssetPackAlignment != 0) {
+      blobs_.push_back(std::byte{0});
+    }
+    PackEntry entry{};
+    entry.kind = kind;
+    entry.id = id;
+    entry.offset = blobs_.size();  // relative until write()
+    entry.size = size;
+    const auto* bytes = static_cast<const std::byte*>(data);
+    blobs_.insert(blobs_.end(), bytes, bytes + size);
+    entries_.push_back(entry);
+    return entries_.back();
+  }
+
+  void write(const std::string& path) {
+    std::size_t dataStart = sizeof(PackHeader) + entries_.size() * sizeof(PackEntry);
+    dataStart = (dataStart + kAssetPackAlignment - 1) / kAssetPackAlignment * kAssetPackAlignment;
+
+    PackHeader header{};
+    std::memcpy(header.magic, kAssetPackMagic, sizeof(header.magic));
+    header.version = kAssetPackVersion;
+    header.entryCount = static_cast<std::uint32_t>(entries_.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("Failed to open " + path + " for writing");
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (PackEntry entry : entries_) {
+      entry.offset += dataStart;
+      out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    const std::vector<char> padding(
+        dataStart - sizeof(PackHeader) - entries_.size() * sizeof(PackEntry), 0);
+    out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    out.write(reinterpret_cast<const char*>(blobs_.data()),
+              static_cast<std::streamsize>(blobs_.size()));
+    if (!out) {
+      throw std::runtime_error("Failed to write " + path);
+    }
+  }
+
+ private:
+  std::vector<PackEntry> entries_;
+  std::vector<std::byte> blobs_;
+};
+
+std::vector<char> readFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "usage: barista-sim-cook <output.pak>\n";
+    return 1;
+  }
+
+  try {
+    PackBuilder pack;
+
+    for (const auto& asset : kTextureManifest) {
+      const std::string path(asset.path);
+      sf::Image image;
+      if (!image.loadFromFile(path)) {
+        throw std::runtime_error("Failed to load texture: " + path);
+      }
+      const sf::Vector2u size = image.getSize();
+      PackEntry& entry = pack.add(AssetKind::Texture, static_cast<std::uint8_t>(asset.id),
+                                  image.getPixelsPtr(), std::size_t{size.x} * size.y * 4);
+      entry.width = size.x;
+      entry.height = size.y;
+    }
+
+    for (const auto& asset : kFontManifest) {
+      const std::vector<char> bytes = readFile(std::string(asset.path));
+      pack.add(AssetKind::Font, static_cast<std::uint8_t>(asset.id), bytes.data(), bytes.size());
+    }
+
+    // Sound effects are short, so they are stored as PCM and skip decoding.
+    for (const auto& asset : kSoundManifest) {
+      const std::string path(asset.path);
+      sf::InputSoundFile file;
+      if (!file.openFromFile(path)) {
+        throw std::runtime_error("Failed to load sound: " + path);
+      }
+      std::vector<sf::Int16> samples(static_cast<std::size_t>(file.getSampleCount()));
+      samples.resize(static_cast<std::size_t>(file.read(samples.data(), samples.size())));
+      PackEntry& entry = pack.add(AssetKind::Sound, static_cast<std::uint8_t>(asset.id),
+                                  samples.data(), samples.size() * sizeof(sf::Int16));
+      entry.channelCount = static_cast<std::uint16_t>(file.getChannelCount());
+      entry.sampleRate = file.getSampleRate();
+    }
+
+    // Music stays compressed; it is streamed from the mapping.
+    for (const auto& asset : kMusicManifest) {
+      const std::vector<char> bytes = readFile(std::string(asset.path));
+      pack.add(AssetKind::Music, static_cast<std::uint8_t>(asset.id), bytes.data(), bytes.size());
+    }
+
+    pack.write(argv[1]);
+  } catch (const std::exception& ex) {
+    std::cerr << "barista-sim-cook: " << ex.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,134 @@
+// barista-sim-flowcheck: checks FlowField::update() against a full build().
+// Starting from a café-sized grid, it moves, adds and removes random
+// colliders, re-bakes and repairs the field incrementally after each edit,
+// and compares the result with a field built from scratch on the same grid.
+//
+//   barista-sim-flowcheck [edits] [seed]
+//
+// Costs must match exactly. Where several neighbours tie, the two fields may
+// step to different ones, so each step is only checked to be legal and to
+// lead to a cell exactly one move cheaper. Exits non-zero on a mismatch; the
+// build registers it with ctest.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Pathfinding.hpp"
+#include "Random.hpp"
+
+namespace {
+// Move costs, as documented on FlowField.
+constexpr std::uint32_t kStraightCost = 5;
+constexpr std::uint32_t kDiagonalCost = 7;
+
+const sf::FloatRect kFloor(0.0f, 0.0f, 1280.0f, 720.0f);
+constexpr float kCellSize = 16.0f;
+const sf::Vector2f kAgentHalfSize(16.0f, 8.0f);
+const std::vector<sf::Vector2f> kGoals = {{560.0f, 330.0f}, {640.0f, 330.0f}, {720.0f, 330.0f}};
+
+sf::FloatRect randomCollider(Random& random) {
+  const float width = random.uniform(16.0f, 240.0f);
+  const float height = random.uniform(16.0f, 160.0f);
+  return {random.uniform(kFloor.left, kFloor.width - width),
+          random.uniform(kFloor.top, kFloor.height - height), width, height};
+}
+
+// Empty when field agrees with reference, otherwise what differs.
+std::string compare(const NavGrid& grid, const FlowField& field, const FlowField& reference) {
+  const std::uint32_t width = grid.width();
+  for (NavGrid::Cell cell = 0; cell < grid.cellCount(); ++cell) {
+    const std::string where = "cell " + std::to_string(cell) + ": ";
+    const std::uint32_t cost = field.cost(cell);
+    if (cost != reference.cost(cell)) {
+      return where + "cost " + std::to_string(cost) + ", expected " +
+             std::to_string(reference.cost(cell));
+    }
+
+    const NavGrid::Cell next = field.next(cell);
+    if (cost == 0 || cost == FlowField::kUnreachable) {
+      if (next != NavGrid::kNoCell) {
+        return where + "steps away from a goal or unreachable cell";
+      }
+      continue;
+    }
+    if (next == NavGrid::kNoCell) {
+      return where + "reachable but has no step";
+    }
+
+    const auto x = static_cast<std::int64_t>(cell % width);
+    const auto y = static_cast<std::int64_t>(cell / width);
+    const auto nextX = static_cast<std::int64_t>(next % width);
+    const auto nextY = static_cast<std::int64_t>(next / width);
+    const std::int64_t dx = nextX - x;
+    const std::int64_t dy = nextY - y;
+    if (dx < -1 || dx > 1 || dy < -1 || dy > 1 || !grid.walkable(next)) {
+      return where + "steps to a cell it cannot move to";
+    }
+    const bool diagonal = dx != 0 && dy != 0;
+    if (diagonal && (!grid.walkable(static_cast<NavGrid::Cell>(y * width + nextX)) ||
+                     !grid.walkable(static_cast<NavGrid::Cell>(nextY * width + x)))) {
+      return where + "steps past a blocked corner";
+    }
+    if (field.cost(next) + (diagonal ? kDiagonalCost : kStraightCost) != cost) {
+      return where + "steps to a cell that is not one move closer";
+    }
+  }
+  return {};
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc > 3) {
+    std::cerr << "usage: barista-sim-flowcheck [edits] [seed]\n";
+    return 1;
+  }
+  const unsigned long edits = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500;
+  const unsigned long long seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+
+  Random random(seed);
+  std::vector<sf::FloatRect> colliders;
+  for (int i = 0; i < 8; ++i) {
+    colliders.push_back(randomCollider(random));
+  }
+
+  NavGrid grid;
+  grid.bake(kFloor, kCellSize, colliders, kAgentHalfSize);
+  FlowField field;
+  field.build(grid, kGoals);
+
+  std::size_t incremental = 0;
+  for (unsigned long edit = 0; edit < edits; ++edit) {
+    // Mostly small moves, the case update() exists for, with the odd
+    // collider appearing or disappearing.
+    const float roll = random.uniform();
+    if (roll < 0.15f && colliders.size() < 16) {
+      colliders.push_back(randomCollider(random));
+    } else if (roll < 0.3f && colliders.size() > 1) {
+      colliders.erase(colliders.begin() + random.next() % colliders.size());
+    } else {
+      sf::FloatRect& moved = colliders[random.next() % colliders.size()];
+      moved.left += random.uniform(-48.0f, 48.0f);
+      moved.top += random.uniform(-48.0f, 48.0f);
+    }
+
+    grid.bake(kFloor, kCellSize, colliders, kAgentHalfSize);
+    field.update();
+    if (!grid.changedCells().empty()) {
+      ++incremental;
+    }
+
+    FlowField reference;
+    reference.build(grid, kGoals);
+    const std::string mismatch = compare(grid, field, reference);
+    if (!mismatch.empty()) {
+      std::cerr << "edit " << edit << " (seed " << seed << "): " << mismatch << "\n";
+      return 1;
+    }
+  }
+
+  std::cout << "flow field matched a full build after " << edits << " edits (" << incremental
+            << " changed the grid)\n";
+  return 0;
+}